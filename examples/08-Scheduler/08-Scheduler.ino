@@ -0,0 +1,50 @@
+/*!
+   ufire.co for links to documentation, examples, and libraries
+   github.com/u-fire for feature requests, bug reports, and  questions
+   questions@ufire.co to get in touch with someone
+
+   Samples two probes every 2 seconds on absolute deadlines. Late cycles
+   skip to the next period rather than drifting, and the jitter and overrun
+   histograms show whether the period suits the number of probes. Jitter
+   is signed: negative when a reading lands before its deadline.
+
+   For hardware version 2, firmware 3
+ */
+#include <uFire_EC.h>
+#include <uFire_EC_Scheduler.h>
+
+uFire_EC ec1;
+uFire_EC ec2;
+uFire_EC_Scheduler scheduler;
+
+void setup()
+{
+  Serial.begin(9600);
+  Wire.begin();
+
+  ec1.begin(0x3c);
+  ec2.begin(0x3d);
+  scheduler.add(&ec1);
+  scheduler.add(&ec2);
+  scheduler.begin(2000);
+}
+
+void loop()
+{
+  if (scheduler.update())
+  {
+    Serial.print((String)"mS/cm: " + ec1.mS + " | " + ec2.mS);
+    Serial.println((String)"  jitter ms: " + scheduler.getLastJitter() + " overruns: " + scheduler.overruns);
+
+    if (scheduler.cycles % 100 == 0)
+    {
+      Serial.print((String)"jitter histogram, " + scheduler.getJitterBin() + " ms bins: ");
+      for (uint8_t i = 0; i < EC_SCHEDULER_BINS; i++)
+      {
+        Serial.print(scheduler.jitterHistogram[i]);
+        Serial.print(" ");
+      }
+      Serial.println();
+    }
+  }
+}
@@ -0,0 +1,76 @@
+/*!
+   ufire.co for links to documentation, examples, and libraries
+   github.com/u-fire for feature requests, bug reports, and  questions
+   questions@ufire.co to get in touch with someone
+
+   Compares the cost of turning register contents into readings with
+   integer math (uFire_EC::toFixed) against the float path. No probe is
+   needed; the register images below stand in for bus reads.
+
+   Code size: with -DUFIRE_EC_FIXED_POINT, a sketch that measures with
+   measureEC_uS() and measureTemp_centi() calls no floating point operations
+   in the library, so an FPU-less board can leave out the soft-float routines.
+   measureEC() and measureTemp() still return floats and pull them back in.
+   `make -C linux bench` runs the same comparison on a Linux host, in a float
+   and a fixed-point build, and prints the .text size of each. A host with an
+   FPU does float math in hardware, so there the float path is the faster one.
+
+   For hardware version 2, firmware 3
+ */
+#include <uFire_EC.h>
+
+#define ITERATIONS 1000
+
+const float samples[] = { 0.5, 1.413, 2.764, 12.88, 20.0 };
+volatile uint32_t bits[5];
+volatile long sink;
+
+void setup()
+{
+  Serial.begin(9600);
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    uint32_t b;
+    memcpy(&b, &samples[i], sizeof(b));
+    bits[i] = b;
+  }
+
+  uint32_t start = micros();
+  for (uint16_t n = 0; n < ITERATIONS; n++)
+  {
+    uint32_t b = bits[n % 5];
+    float    mS;
+    memcpy(&mS, &b, sizeof(mS));
+    sink = mS * 1000;
+    sink = mS * 500;
+    sink = mS * 640;
+    sink = mS * 700;
+    sink = ((mS * 9) / 5) + 32;
+  }
+  uint32_t floatTime = micros() - start;
+
+  start = micros();
+  for (uint16_t n = 0; n < ITERATIONS; n++)
+  {
+    long uS = uFire_EC::toFixed(bits[n % 5], 1000);
+    sink = uS;
+    sink = uS / 2;
+    sink = (uS * 16) / 25;
+    sink = (uS * 7) / 10;
+    sink = ((uS * 9) / 5) + 3200;
+  }
+  uint32_t fixedTime = micros() - start;
+
+  Serial.print("float ns/reading: ");
+  Serial.println(floatTime * 1000 / ITERATIONS);
+  Serial.print("fixed ns/reading: ");
+  Serial.println(fixedTime * 1000 / ITERATIONS);
+  Serial.print("float cycles/reading: ");
+  Serial.println((F_CPU / 1000000) * floatTime / ITERATIONS);
+  Serial.print("fixed cycles/reading: ");
+  Serial.println((F_CPU / 1000000) * fixedTime / ITERATIONS);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,39 @@
+/*!
+   ufire.co for links to documentation, examples, and libraries
+   github.com/u-fire for feature requests, bug reports, and  questions
+   questions@ufire.co to get in touch with someone
+
+   Summarizes every 60 readings on the node instead of sending each one,
+   and reports calibration drift or fouling when the trend suggests it.
+
+   For hardware version 2, firmware 3
+ */
+#include <uFire_EC.h>
+#include <uFire_EC_Stats.h>
+
+uFire_EC ec;
+uFire_EC_Stats stats;
+
+void setup()
+{
+  Serial.begin(9600);
+  Wire.begin();
+
+  ec.begin();
+  stats.begin(&ec, 60);
+}
+
+void loop()
+{
+  ec.measureEC();
+
+  if (stats.available())
+  {
+    const uFire_EC_Summary &s = stats.summary();
+    Serial.println((String)"mean: " + s.mean + " var: " + s.variance + " min: " + s.min + " max: " + s.max);
+    Serial.println((String)"slope mS/h: " + s.slope);
+    if (s.drift & EC_DRIFT_TREND) Serial.println("calibration drifting");
+    if (s.drift & EC_DRIFT_FOULING) Serial.println("probe may be fouled");
+    if (s.drift & EC_DRIFT_RANGE) Serial.println("reading outside calibrated range");
+  }
+}
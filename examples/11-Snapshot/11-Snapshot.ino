@@ -0,0 +1,47 @@
+/*!
+   ufire.co for links to documentation, examples, and libraries
+   github.com/u-fire for feature requests, bug reports, and  questions
+   questions@ufire.co to get in touch with someone
+
+   ESP32: one task samples the probe, another reads the latest complete
+   reading whenever it likes without blocking the sampler.
+
+   For hardware version 2, firmware 3
+ */
+#include <uFire_EC.h>
+#include <uFire_EC_Snapshot.h>
+
+uFire_EC ec;
+uFire_EC_Snapshot snapshot;
+
+void sample(void *)
+{
+  for (;;)
+  {
+    ec.measureEC();
+  }
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  Wire.begin();
+
+  ec.begin();
+  snapshot.begin(&ec);
+  xTaskCreate(sample, "sample", 4096, NULL, 1, NULL);
+}
+
+void loop()
+{
+  static uint32_t last = 0;
+  uFire_EC_Reading reading;
+  uint32_t seq = snapshot.read(reading);
+
+  if (seq != last)
+  {
+    last = seq;
+    Serial.println((String)"mS/cm: " + reading.mS() + " C: " + reading.tempC());
+  }
+  delay(100);
+}
@@ -0,0 +1,104 @@
+#include "Arduino.h"
+#include <stdio.h>
+#include <time.h>
+
+static uint64_t now_us()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static const uint64_t start_us = now_us();
+
+unsigned long millis()
+{
+  return (uint32_t)((now_us() - start_us) / 1000);
+}
+
+unsigned long micros()
+{
+  return (uint32_t)(now_us() - start_us);
+}
+
+void delay(unsigned long ms)
+{
+  struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000 };
+
+  while (nanosleep(&ts, &ts) != 0) {}
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+
+  while (nanosleep(&ts, &ts) != 0) {}
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::write(const char *str)
+{
+  return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const char *str)
+{
+  return write(str);
+}
+
+size_t Print::print(char c)
+{
+  return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base)
+{
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base)
+{
+  return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+  char buf[24];
+
+  snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", n);
+  return write(buf);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  char buf[24];
+
+  snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%lu", n);
+  return write(buf);
+}
+
+size_t Print::print(double n, int digits)
+{
+  char buf[48];
+
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+size_t Print::println()
+{
+  return write("\r\n");
+}
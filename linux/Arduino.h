@@ -0,0 +1,63 @@
+#pragma once
+
+// Just enough of the Arduino core for the uFire_EC library to build on Linux.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEC 10
+#define HEX 16
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) (bitvalue ? bitSet(value, bit) : bitClear(value, bit))
+
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+
+class Print
+{
+public:
+  virtual ~Print(){}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t         write(const char *str);
+
+  size_t print(const char *str);
+  size_t print(char c);
+  size_t print(unsigned char n, int base=DEC);
+  size_t print(int n, int base=DEC);
+  size_t print(unsigned int n, int base=DEC);
+  size_t print(long n, int base=DEC);
+  size_t print(unsigned long n, int base=DEC);
+  size_t print(double n, int digits=2);
+
+  size_t println();
+  template<typename T>
+  size_t println(T value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+
+  template<typename T>
+  size_t println(T value, int format)
+  {
+    size_t n = print(value, format);
+    return n + println();
+  }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
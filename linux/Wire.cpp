@@ -0,0 +1,383 @@
+#include "Wire.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+TwoWire Wire(1);
+
+TwoWire::TwoWire(int bus) : _bus(bus)
+{}
+
+TwoWire::~TwoWire()
+{
+  stopRecording();
+  end();
+}
+
+bool TwoWire::begin()
+{
+  char device[24];
+
+  if (_replaying) return true;
+  snprintf(device, sizeof(device), "/dev/i2c-%d", _bus);
+  return begin(device);
+}
+
+bool TwoWire::begin(const char *device)
+{
+  end();
+  _replaying = false;
+  _fd        = open(device, O_RDWR);
+  _error     = _fd < 0 ? errno : 0;
+  return _fd >= 0;
+}
+
+void TwoWire::end()
+{
+  if (_fd >= 0) close(_fd);
+  _fd = -1;
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+  // the bus rate belongs to the kernel driver (device tree), so only remember it
+  _clock = clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _address     = address;
+  _tx_len      = 0;
+  _tx_overflow = false;
+}
+
+uint8_t TwoWire::endTransmission(bool stop)
+{
+  (void)stop;
+  if (_tx_overflow) return 1;
+  if (_transfer(false, _tx, _tx_len)) return 0;
+  return _status(_error);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+  if (quantity > WIRE_BUFFER_LENGTH) quantity = WIRE_BUFFER_LENGTH;
+
+  _address = address;
+  _rx_pos  = 0;
+  _rx_len  = _transfer(true, _rx, quantity) ? quantity : 0;
+  return _rx_len;
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+  if (_tx_len >= WIRE_BUFFER_LENGTH)
+  {
+    _tx_overflow = true;
+    return 0;
+  }
+  _tx[_tx_len++] = c;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  size_t n = 0;
+
+  while (quantity-- && write(*data++)) n++;
+  return n;
+}
+
+int TwoWire::available()
+{
+  return _rx_len - _rx_pos;
+}
+
+int TwoWire::read()
+{
+  return _rx_pos < _rx_len ? _rx[_rx_pos++] : -1;
+}
+
+int TwoWire::peek()
+{
+  return _rx_pos < _rx_len ? _rx[_rx_pos] : -1;
+}
+
+int TwoWire::getError()
+{
+  return _error;
+}
+
+uint32_t TwoWire::getErrors()
+{
+  return _errors;
+}
+
+uint32_t TwoWire::getClock()
+{
+  return _clock;
+}
+
+uint32_t TwoWire::getTransactions()
+{
+  return _transactions;
+}
+
+uint64_t TwoWire::getBusTime()
+{
+  return _bus_us;
+}
+
+bool TwoWire::record(const char *path)
+{
+  FILE *file = fopen(path, "wb");
+
+  if (!file) return false;
+  record(file);
+  _capture_owned = true;
+  return true;
+}
+
+bool TwoWire::record(FILE *file)
+{
+  stopRecording();
+  _capture       = file;
+  _capture_owned = false;
+  _capture_start = micros();
+  fwrite(WIRE_CAPTURE_MAGIC, 1, 4, _capture);
+  fputc(WIRE_CAPTURE_VERSION, _capture);
+  return true;
+}
+
+void TwoWire::stopRecording()
+{
+  if (!_capture) return;
+  if (_capture_owned) fclose(_capture);
+  else fflush(_capture);
+  _capture = nullptr;
+}
+
+bool TwoWire::replay(const char *path, bool latency)
+{
+  FILE   *file = fopen(path, "rb");
+  uint8_t header[WIRE_CAPTURE_HEADER];
+  uint8_t data[256];
+
+  if (!file) return false;
+  if ((fread(header, 1, 5, file) != 5) || memcmp(header, WIRE_CAPTURE_MAGIC, 4) ||
+      (header[4] != WIRE_CAPTURE_VERSION))
+  {
+    fclose(file);
+    return false;
+  }
+
+  std::map<uint16_t, std::vector<uint16_t> > durations;
+
+  end();
+  _replay_reads.clear();
+  _replay_writes.clear();
+  _replay_estimates.clear();
+  for (uint8_t i = 0; i < 128; i++) _pointer[i] = 0;
+
+  // reads are filed under the register the device pointer was on, so a
+  // library that groups its transfers differently still gets the values the
+  // device returned for each register, in the order it returned them
+  while (fread(header, 1, WIRE_CAPTURE_HEADER, file) == WIRE_CAPTURE_HEADER)
+  {
+    uint8_t  status  = header[0] >> 4;
+    uint8_t  address = header[1] & 0x7F;
+    uint8_t  len     = header[2];
+    uint16_t us      = header[7] | (header[8] << 8);
+
+    bool     reading = header[0] & WIRE_CAPTURE_READ;
+
+    if ((!reading || status == 0) && fread(data, 1, len, file) != len) break;
+
+    // durations by direction and length, then by direction alone (0x200)
+    durations[(reading << 8) | len].push_back(us);
+    durations[0x200 | reading].push_back(us);
+
+    if (!reading)
+    {
+      uint16_t reg = len ? data[0] : 0x100;
+      _replay_writes[(address << 9) | reg].push_back({ (int16_t)-status, us });
+      if (status == 0 && len) _pointer[address] = data[0] + len - 1;
+    }
+    else if (status)
+    {
+      _replay_reads[(address << 9) | _pointer[address]].steps.push_back({ (int16_t)-status, us });
+    }
+    else
+    {
+      for (uint8_t i = 0; i < len; i++)
+      {
+        ReplayStep step = { data[i], (uint16_t)(i ? 0 : us) };
+        _replay_reads[(address << 9) | ((_pointer[address] + i) & 0xFF)].steps.push_back(step);
+      }
+      _pointer[address] += len;
+    }
+  }
+  fclose(file);
+
+  for (auto &d : durations)
+  {
+    std::vector<uint16_t> &v = d.second;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    _replay_estimates[d.first] = v[v.size() / 2];
+  }
+
+  for (uint8_t i = 0; i < 128; i++) _pointer[i] = 0;
+  _replaying      = true;
+  _replay_latency = latency;
+  return true;
+}
+
+bool TwoWire::_transfer(bool reading, uint8_t *data, uint8_t len)
+{
+  struct i2c_msg msg;
+  struct i2c_rdwr_ioctl_data xfer;
+  uint32_t start = micros();
+  uint16_t us    = 0;
+  bool     ok;
+
+  if (_replaying)
+  {
+    ok = _transfer_replay(reading, data, len, &us);
+    if (_replay_latency && us) delayMicroseconds(us);
+  }
+  else
+  {
+    msg.addr   = _address;
+    msg.flags  = reading ? I2C_M_RD : 0;
+    msg.len    = len;
+    msg.buf    = data;
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    ok = (_fd >= 0 || begin()) && ioctl(_fd, I2C_RDWR, &xfer) >= 0;
+    if (ok) _error = 0;
+    else if (_fd >= 0) _error = errno;
+  }
+
+  // a replay is charged the recorded device time, not its own overhead, so
+  // replays of the same traffic add up to the same bus time
+  uint32_t elapsed = _replaying ? us : micros() - start;
+  if (!ok) _errors++;
+  _transactions++;
+  _bus_us += elapsed;
+  if (_capture) _capture_record(reading, data, len, start, elapsed);
+  return ok;
+}
+
+bool TwoWire::_transfer_replay(bool reading, uint8_t *data, uint8_t len, uint16_t *us)
+{
+  uint8_t address = _address & 0x7F;
+
+  if (!reading)
+  {
+    auto q = _replay_writes.find((address << 9) | (len ? data[0] : 0x100));
+
+    if (q != _replay_writes.end() && !q->second.empty())
+    {
+      ReplayStep step = q->second.front();
+      q->second.pop_front();
+      *us = step.us;
+      if (step.value < 0)
+      {
+        _error = step.value == -2 ? ENXIO : EIO;
+        return false;
+      }
+    }
+    else if (_replay_reads.lower_bound(address << 9) == _replay_reads.lower_bound((address + 1) << 9) &&
+             _replay_writes.lower_bound(address << 9) == _replay_writes.lower_bound((address + 1) << 9))
+    {
+      *us    = _replay_estimate(false, len);
+      _error = ENXIO;  // nothing was ever recorded at this address
+      return false;
+    }
+    else *us = _replay_estimate(false, len);
+    if (len) _pointer[address] = data[0] + len - 1;
+    _error = 0;
+    return true;
+  }
+
+  // a read that runs past what was recorded is charged what such a read
+  // usually took, so extra traffic still costs bus time
+  bool unmatched = false;
+
+  for (uint8_t i = 0; i < len; i++)
+  {
+    uint16_t reg = (_pointer[address] + i) & 0xFF;
+    auto     r   = _replay_reads.find((address << 9) | reg);
+
+    if (r == _replay_reads.end())
+    {
+      data[i]   = 0xFF;
+      unmatched = true;
+      continue;
+    }
+
+    // a register keeps answering its last recorded value once its queue is spent
+    ReplayRegister &rr = r->second;
+    if (!rr.steps.empty())
+    {
+      ReplayStep step = rr.steps.front();
+      rr.steps.pop_front();
+      *us += step.us;
+      if (step.value < 0)
+      {
+        _error = step.value == -2 ? ENXIO : EIO;
+        return false;
+      }
+      rr.last = step.value;
+    }
+    else unmatched = true;
+    data[i] = rr.last;
+  }
+  if (unmatched) *us = std::max(*us, _replay_estimate(true, len));
+  _pointer[address] += len;
+  _error = 0;
+  return true;
+}
+
+// the median recorded duration for transfers in that direction of that length,
+// else of any length, else 0 for an empty capture
+uint16_t TwoWire::_replay_estimate(bool reading, uint8_t len)
+{
+  auto e = _replay_estimates.find((reading << 8) | len);
+
+  if (e == _replay_estimates.end()) e = _replay_estimates.find(0x200 | reading);
+  return e == _replay_estimates.end() ? 0 : e->second;
+}
+
+void TwoWire::_capture_record(bool reading, const uint8_t *data, uint8_t len, uint32_t start, uint32_t us)
+{
+  uint8_t  status = _status(_error);
+  uint32_t t      = start - _capture_start;
+  uint8_t  header[WIRE_CAPTURE_HEADER];
+
+  if (us > 0xFFFF) us = 0xFFFF;
+  header[0] = (reading ? WIRE_CAPTURE_READ : 0) | (status << 4);
+  header[1] = _address;
+  header[2] = len;
+  header[3] = t;
+  header[4] = t >> 8;
+  header[5] = t >> 16;
+  header[6] = t >> 24;
+  header[7] = us;
+  header[8] = us >> 8;
+  fwrite(header, 1, sizeof(header), _capture);
+  // a failed write keeps its bytes so its register can be replayed as failing
+  if (!reading || status == 0) fwrite(data, 1, len, _capture);
+}
+
+uint8_t TwoWire::_status(int error)
+{
+  if (error == 0) return 0;
+  return (error == ENXIO || error == EREMOTEIO) ? 2 : 4;
+}
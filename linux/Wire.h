@@ -0,0 +1,97 @@
+#pragma once
+
+// TwoWire over the Linux i2c-dev interface (/dev/i2c-N). It can also record
+// every transfer to a capture file and later replay that capture in place of
+// the bus.
+
+#include "Arduino.h"
+#include <stdio.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+#define WIRE_BUFFER_LENGTH 32
+
+// A capture is WIRE_CAPTURE_MAGIC and a version byte, then one record per
+// transfer, little endian:
+//   u8  flags      WIRE_CAPTURE_READ, status (endTransmission code) in the top nibble
+//   u8  address
+//   u8  length     bytes transferred or requested
+//   u32 time       microseconds since recording started
+//   u16 duration   microseconds spent in the transfer, saturated
+//   u8  data[length], always for a write, for a read only when status is 0
+#define WIRE_CAPTURE_MAGIC "UECI"
+#define WIRE_CAPTURE_VERSION 2
+#define WIRE_CAPTURE_READ 0x01
+#define WIRE_CAPTURE_HEADER 9
+
+class TwoWire : public Stream
+{
+public:
+  TwoWire(int bus=1);
+  ~TwoWire();
+  bool     begin();
+  bool     begin(const char *device);
+  void     end();
+  void     setClock(uint32_t clock);
+  void     beginTransmission(uint8_t address);
+  uint8_t  endTransmission(bool stop=true);
+  uint8_t  requestFrom(uint8_t address, uint8_t quantity);
+  size_t   write(uint8_t c);
+  size_t   write(const uint8_t *data, size_t quantity);
+  int      available();
+  int      read();
+  int      peek();
+  int      getError();
+  uint32_t getErrors();
+  uint32_t getClock();
+  bool     record(const char *path);
+  bool     record(FILE *file);
+  void     stopRecording();
+  bool     replay(const char *path, bool latency=false);
+  uint32_t getTransactions();
+  uint64_t getBusTime();
+
+private:
+  struct ReplayStep
+  {
+    int16_t  value;                 // byte served, or -status for a failed transfer
+    uint16_t us;
+  };
+  struct ReplayRegister
+  {
+    std::deque<ReplayStep> steps;
+    uint8_t last = 0xFF;
+  };
+
+  int      _bus;
+  int      _fd = -1;
+  uint32_t _clock = 100000;
+  uint8_t  _address = 0;
+  uint8_t  _tx[WIRE_BUFFER_LENGTH];
+  uint8_t  _tx_len = 0;
+  bool     _tx_overflow = false;
+  uint8_t  _rx[WIRE_BUFFER_LENGTH];
+  uint8_t  _rx_len = 0;
+  uint8_t  _rx_pos = 0;
+  int      _error = 0;
+  uint32_t _errors = 0;
+  uint32_t _transactions = 0;
+  uint64_t _bus_us = 0;
+  FILE    *_capture = nullptr;
+  bool     _capture_owned = false;
+  uint32_t _capture_start;
+  bool     _replaying = false;
+  bool     _replay_latency = false;
+  uint16_t _pointer[128];
+  std::map<uint16_t, ReplayRegister> _replay_reads;
+  std::map<uint16_t, std::deque<ReplayStep> > _replay_writes;
+  std::map<uint16_t, uint16_t> _replay_estimates;
+  bool     _transfer(bool reading, uint8_t *data, uint8_t len);
+  bool     _transfer_replay(bool reading, uint8_t *data, uint8_t len, uint16_t *us);
+  uint16_t _replay_estimate(bool reading, uint8_t len);
+  void     _capture_record(bool reading, const uint8_t *data, uint8_t len, uint32_t start, uint32_t us);
+  static uint8_t _status(int error);
+};
+
+extern TwoWire Wire;
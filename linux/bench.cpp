@@ -0,0 +1,65 @@
+// Host counterpart of examples/09-FixedPointBenchmark: times turning register
+// contents into readings with uFire_EC::toFixed() against the float path.
+// `make bench` builds it once per configuration and prints the .text size of
+// the library in each.
+
+#include "uFire_EC.h"
+#include <chrono>
+#include <stdio.h>
+
+#define ITERATIONS 10000000
+
+static const float samples[] = { 0.5, 1.413, 2.764, 12.88, 20.0 };
+static volatile uint32_t bits[5];
+static volatile long sink;
+
+static double _ns_per_reading(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / ITERATIONS;
+}
+
+int main()
+{
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    uint32_t b;
+    memcpy(&b, &samples[i], sizeof(b));
+    bits[i] = b;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ITERATIONS; n++)
+  {
+    uint32_t b = bits[n % 5];
+    float    mS;
+    memcpy(&mS, &b, sizeof(mS));
+    sink = mS * 1000;
+    sink = mS * 500;
+    sink = mS * 640;
+    sink = mS * 700;
+    sink = ((mS * 9) / 5) + 32;
+  }
+  double floatTime = _ns_per_reading(start);
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < ITERATIONS; n++)
+  {
+    long uS = uFire_EC::toFixed(bits[n % 5], 1000);
+    sink = uS;
+    sink = uS / 2;
+    sink = (uS * 16) / 25;
+    sink = (uS * 7) / 10;
+    sink = ((uS * 9) / 5) + 3200;
+  }
+  double fixedTime = _ns_per_reading(start);
+
+#if defined(UFIRE_EC_FIXED_POINT)
+  printf("configuration: UFIRE_EC_FIXED_POINT\n");
+#else // if defined(UFIRE_EC_FIXED_POINT)
+  printf("configuration: float\n");
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+  printf("float ns/reading: %.2f\n", floatTime);
+  printf("fixed ns/reading: %.2f\n", fixedTime);
+  return 0;
+}
@@ -0,0 +1,76 @@
+// Replays hand-built captures through the C interface and checks that a
+// recorded NACK comes back as a failed call. Run with `make check`.
+
+#include "ufire_ec.h"
+#include "Wire.h"
+#include "uFire_EC.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NACK 2
+
+static const char *_path = "build/replay_check.bin";
+static int         _failures = 0;
+
+static void _record(FILE *f, bool reading, uint8_t status, const uint8_t *data, uint8_t len)
+{
+  uint8_t header[WIRE_CAPTURE_HEADER] = { 0 };
+
+  header[0] = (reading ? WIRE_CAPTURE_READ : 0) | (status << 4);
+  header[1] = 0x3c;
+  header[2] = len;
+  header[7] = 100;  // duration, 100 us
+  fwrite(header, 1, sizeof(header), f);
+  if (!reading || status == 0) fwrite(data, 1, len, f);
+}
+
+// the version probe every replayed open starts with, then one failed write
+static void _capture(const uint8_t *nacked, uint8_t len)
+{
+  FILE   *f       = fopen(_path, "wb");
+  uint8_t pointer = EC_VERSION_REGISTER;
+  uint8_t version = 1;
+
+  fwrite(WIRE_CAPTURE_MAGIC, 1, 4, f);
+  fputc(WIRE_CAPTURE_VERSION, f);
+  _record(f, false, 0, &pointer, 1);
+  _record(f, true, 0, &version, 1);
+  _record(f, false, NACK, nacked, len);
+  fclose(f);
+}
+
+static void _expect(const char *name, int got, int want)
+{
+  printf("%-28s %s\n", name, got == want ? "ok" : "FAIL");
+  if (got != want)
+  {
+    printf("  got %s, want %s\n", ufire_ec_strerror(got), ufire_ec_strerror(want));
+    _failures++;
+  }
+}
+
+int main()
+{
+  int       error;
+  float     value;
+  ufire_ec *ec;
+
+  // setTempCoefficient() writes the register byte and 4 data bytes
+  uint8_t write[5] = { EC_TEMPCOEF_REGISTER, 0x8b, 0x6c, 0x9b, 0x3c };
+  _capture(write, sizeof(write));
+  ec = ufire_ec_open_replay(_path, 0x3c, 0, &error);
+  _expect("open", error, UFIRE_EC_OK);
+  if (ec) _expect("NACKed write", ufire_ec_set_temp_coefficient(ec, 0.019), UFIRE_EC_ERR_IO);
+  ufire_ec_close(ec);
+
+  // getTempCoefficient() first moves the register pointer
+  uint8_t pointer = EC_TEMPCOEF_REGISTER;
+  _capture(&pointer, 1);
+  ec = ufire_ec_open_replay(_path, 0x3c, 0, &error);
+  _expect("open", error, UFIRE_EC_OK);
+  if (ec) _expect("NACKed pointer write", ufire_ec_get_temp_coefficient(ec, &value), UFIRE_EC_ERR_IO);
+  ufire_ec_close(ec);
+
+  remove(_path);
+  return _failures ? 1 : 0;
+}
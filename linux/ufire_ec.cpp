@@ -0,0 +1,317 @@
+#include "ufire_ec.h"
+#include "uFire_EC.h"
+#include "uFire_EC_Snapshot.h"
+
+#define UFIRE_EC_API extern "C" __attribute__((visibility("default")))
+
+struct ufire_ec
+{
+  TwoWire           wire;
+  uFire_EC          ec;
+  uFire_EC_Snapshot snapshot;
+
+  ufire_ec(int bus) : wire(bus)
+  {}
+};
+
+// the core does not report bus errors itself, so compare the bus error
+// count around each call
+#define EC_CALL(h, expr)                                 \
+  do {                                                   \
+    if (!(h)) return UFIRE_EC_ERR_ARG;                   \
+    uint32_t errors = (h)->wire.getErrors();             \
+    expr;                                                \
+    if ((h)->wire.getErrors() != errors) return UFIRE_EC_ERR_IO; \
+    return UFIRE_EC_OK;                                  \
+  } while (0)
+
+static ufire_ec *_open(ufire_ec *h, bool opened, uint8_t address, int *error)
+{
+  int err = UFIRE_EC_OK;
+
+  if (!opened) err = UFIRE_EC_ERR_OPEN;
+  else if (!h->ec.begin(address, h->wire)) err = UFIRE_EC_ERR_NOT_CONNECTED;
+
+  if (error) *error = err;
+  if (err == UFIRE_EC_OK)
+  {
+    h->snapshot.begin(&h->ec);
+    return h;
+  }
+  delete h;
+  return nullptr;
+}
+
+UFIRE_EC_API int ufire_ec_abi_version(void)
+{
+  return UFIRE_EC_ABI_VERSION;
+}
+
+UFIRE_EC_API const char *ufire_ec_strerror(int error)
+{
+  switch (error)
+  {
+  case UFIRE_EC_OK: return "ok";
+  case UFIRE_EC_ERR_OPEN: return "cannot open I2C bus";
+  case UFIRE_EC_ERR_IO: return "I2C transaction failed";
+  case UFIRE_EC_ERR_NOT_CONNECTED: return "device not connected";
+  case UFIRE_EC_ERR_ARG: return "invalid argument";
+  default: return "unknown error";
+  }
+}
+
+UFIRE_EC_API ufire_ec *ufire_ec_open(int bus, uint8_t address, int *error)
+{
+  ufire_ec *h = new ufire_ec(bus);
+
+  return _open(h, h->wire.begin(), address, error);
+}
+
+UFIRE_EC_API ufire_ec *ufire_ec_open_device(const char *device, uint8_t address, int *error)
+{
+  if (!device)
+  {
+    if (error) *error = UFIRE_EC_ERR_ARG;
+    return nullptr;
+  }
+
+  ufire_ec *h = new ufire_ec(-1);
+  return _open(h, h->wire.begin(device), address, error);
+}
+
+UFIRE_EC_API ufire_ec *ufire_ec_open_replay(const char *capture, uint8_t address, int latency, int *error)
+{
+  if (!capture)
+  {
+    if (error) *error = UFIRE_EC_ERR_ARG;
+    return nullptr;
+  }
+
+  ufire_ec *h = new ufire_ec(-1);
+  int       err = UFIRE_EC_OK;
+
+  if (!h->wire.replay(capture, latency != 0)) err = UFIRE_EC_ERR_OPEN;
+  else
+  {
+    // a capture usually starts after the device was opened, so it may not
+    // hold the version register; only a capture without any traffic for
+    // this address makes the replayed device absent
+    h->ec.begin(address, h->wire);
+    if (h->wire.getErrors()) err = UFIRE_EC_ERR_NOT_CONNECTED;
+  }
+
+  if (error) *error = err;
+  if (err != UFIRE_EC_OK)
+  {
+    delete h;
+    return nullptr;
+  }
+
+  // the capture already holds the results, so skip the conversion waits
+  h->ec.setBlocking(false);
+  h->snapshot.begin(&h->ec);
+  return h;
+}
+
+UFIRE_EC_API void ufire_ec_close(ufire_ec *h)
+{
+  if (!h) return;
+  h->snapshot.end();
+  h->wire.stopRecording();
+  h->wire.end();
+  delete h;
+}
+
+UFIRE_EC_API int ufire_ec_connected(ufire_ec *h)
+{
+  if (!h) return UFIRE_EC_ERR_ARG;
+  return h->ec.connected() ? UFIRE_EC_OK : UFIRE_EC_ERR_NOT_CONNECTED;
+}
+
+UFIRE_EC_API int ufire_ec_measure_ec(ufire_ec *h, float temp, float temp_constant, float *mS)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.measureEC(temp, temp_constant); if (mS) *mS = v);
+}
+
+UFIRE_EC_API int ufire_ec_measure_temp(ufire_ec *h, float *tempC)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.measureTemp(); if (tempC) *tempC = v);
+}
+
+UFIRE_EC_API int ufire_ec_snapshot(ufire_ec *h, ufire_ec_reading *reading)
+{
+  uFire_EC_Reading r;
+
+  if (!h || !reading) return UFIRE_EC_ERR_ARG;
+  reading->sequence    = h->snapshot.read(r);
+  reading->mS          = r.mS();
+  reading->raw         = r.raw();
+  reading->salinityPSU = r.salinityPSU();
+  reading->tempC       = r.tempC();
+  return UFIRE_EC_OK;
+}
+
+UFIRE_EC_API int ufire_ec_calibrate(ufire_ec *h, float solutionEC, float tempC, float *offset)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.calibrateProbe(solutionEC, tempC); if (offset) *offset = v);
+}
+
+UFIRE_EC_API int ufire_ec_calibrate_low(ufire_ec *h, float solutionEC, float tempC, float *reading)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.calibrateProbeLow(solutionEC, tempC); if (reading) *reading = v);
+}
+
+UFIRE_EC_API int ufire_ec_calibrate_high(ufire_ec *h, float solutionEC, float tempC, float *reading)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.calibrateProbeHigh(solutionEC, tempC); if (reading) *reading = v);
+}
+
+UFIRE_EC_API int ufire_ec_set_dual_point(ufire_ec *h, float refLow, float refHigh, float readLow, float readHigh)
+{
+  EC_CALL(h, h->ec.setDualPointCalibration(refLow, refHigh, readLow, readHigh));
+}
+
+UFIRE_EC_API int ufire_ec_get_calibration(ufire_ec *h, ufire_ec_calibration *calibration)
+{
+  uFire_EC_Burst<EC_Reg_CalibrateRefHigh, EC_Reg_CalibrateRefLow, EC_Reg_CalibrateReadHigh,
+                 EC_Reg_CalibrateReadLow, EC_Reg_CalibrateOffset> cal;
+
+  if (!calibration) return UFIRE_EC_ERR_ARG;
+  EC_CALL(h,
+          h->ec.read(cal);
+          calibration->refHigh  = cal.get<EC_Reg_CalibrateRefHigh>();
+          calibration->refLow   = cal.get<EC_Reg_CalibrateRefLow>();
+          calibration->readHigh = cal.get<EC_Reg_CalibrateReadHigh>();
+          calibration->readLow  = cal.get<EC_Reg_CalibrateReadLow>();
+          calibration->offset   = cal.get<EC_Reg_CalibrateOffset>());
+}
+
+UFIRE_EC_API int ufire_ec_set_offset(ufire_ec *h, float offset)
+{
+  EC_CALL(h, h->ec.setCalibrateOffset(offset));
+}
+
+UFIRE_EC_API int ufire_ec_reset(ufire_ec *h)
+{
+  EC_CALL(h, h->ec.reset());
+}
+
+UFIRE_EC_API int ufire_ec_set_temp_coefficient(ufire_ec *h, float tempCoef)
+{
+  EC_CALL(h, h->ec.setTempCoefficient(tempCoef));
+}
+
+UFIRE_EC_API int ufire_ec_get_temp_coefficient(ufire_ec *h, float *tempCoef)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.getTempCoefficient(); if (tempCoef) *tempCoef = v);
+}
+
+UFIRE_EC_API int ufire_ec_set_temp_constant(ufire_ec *h, float tempConstant)
+{
+  EC_CALL(h, h->ec.setTempConstant(tempConstant));
+}
+
+UFIRE_EC_API int ufire_ec_get_temp_constant(ufire_ec *h, float *tempConstant)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.getTempConstant(); if (tempConstant) *tempConstant = v);
+}
+
+UFIRE_EC_API int ufire_ec_set_temp(ufire_ec *h, float tempC)
+{
+  EC_CALL(h, h->ec.setTemp(tempC));
+}
+
+// useTemperatureCompensation() is private to the core, which turns
+// compensation on for every EC measurement; this sets the same config bit
+UFIRE_EC_API int ufire_ec_use_temp_compensation(ufire_ec *h, int enable)
+{
+  uint8_t config;
+
+  EC_CALL(h,
+          config = h->ec.read<EC_Reg_Config>();
+          if (enable) config |= 1 << EC_TEMP_COMPENSATION_CONFIG_BIT;
+          else config &= ~(1 << EC_TEMP_COMPENSATION_CONFIG_BIT);
+          h->ec.write<EC_Reg_Config>(config));
+}
+
+UFIRE_EC_API int ufire_ec_version(ufire_ec *h, uint8_t *hardware, uint8_t *firmware)
+{
+  uint8_t hw, fw;
+
+  EC_CALL(h,
+          hw = h->ec.getVersion();
+          fw = h->ec.getFirmware();
+          if (hardware) *hardware = hw;
+          if (firmware) *firmware = fw);
+}
+
+UFIRE_EC_API int ufire_ec_set_address(ufire_ec *h, uint8_t address)
+{
+  if (address < 1 || address > 127) return UFIRE_EC_ERR_ARG;
+  EC_CALL(h, h->ec.setI2CAddress(address));
+}
+
+UFIRE_EC_API int ufire_ec_read_eeprom(ufire_ec *h, uint8_t address, float *value)
+{
+  float v;
+
+  EC_CALL(h, v = h->ec.readEEPROM(address); if (value) *value = v);
+}
+
+UFIRE_EC_API int ufire_ec_write_eeprom(ufire_ec *h, uint8_t address, float value)
+{
+  EC_CALL(h, h->ec.writeEEPROM(address, value));
+}
+
+UFIRE_EC_API int ufire_ec_read_data(ufire_ec *h)
+{
+  EC_CALL(h, h->ec.readData());
+}
+
+UFIRE_EC_API int ufire_ec_set_blocking(ufire_ec *h, int blocking)
+{
+  if (!h) return UFIRE_EC_ERR_ARG;
+  h->ec.setBlocking(blocking != 0);
+  return UFIRE_EC_OK;
+}
+
+UFIRE_EC_API int ufire_ec_get_blocking(ufire_ec *h, int *blocking)
+{
+  if (!h || !blocking) return UFIRE_EC_ERR_ARG;
+  *blocking = h->ec.getBlocking();
+  return UFIRE_EC_OK;
+}
+
+UFIRE_EC_API int ufire_ec_record(ufire_ec *h, const char *capture)
+{
+  if (!h) return UFIRE_EC_ERR_ARG;
+  if (!capture)
+  {
+    h->wire.stopRecording();
+    return UFIRE_EC_OK;
+  }
+  return h->wire.record(capture) ? UFIRE_EC_OK : UFIRE_EC_ERR_OPEN;
+}
+
+UFIRE_EC_API int ufire_ec_bus_stats_get(ufire_ec *h, ufire_ec_bus_stats *stats)
+{
+  if (!h || !stats) return UFIRE_EC_ERR_ARG;
+  stats->transactions = h->wire.getTransactions();
+  stats->errors       = h->wire.getErrors();
+  stats->bus_us       = h->wire.getBusTime();
+  return UFIRE_EC_OK;
+}
@@ -0,0 +1,97 @@
+#ifndef UFIRE_EC_C_H
+#define UFIRE_EC_C_H
+
+// Plain C interface to the uFire_EC core on a Linux I2C bus, exported by
+// libufire_ec.so for Python, Rust and other language bindings. Every call
+// returns UFIRE_EC_OK or a negative UFIRE_EC_ERR_* code; results come back
+// through pointers. Calls on one handle must not overlap, except
+// ufire_ec_snapshot() which any thread may call at any time.
+//
+// ufire_ec_record() saves every bus transfer to a capture file, and
+// ufire_ec_open_replay() answers from such a capture instead of the bus, so a
+// recorded session can be run again against another build of the library.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UFIRE_EC_ABI_VERSION 1          /*!< bumped on any incompatible change */
+
+#define UFIRE_EC_OK 0                   /*!< success */
+#define UFIRE_EC_ERR_OPEN -1            /*!< the I2C bus device could not be opened */
+#define UFIRE_EC_ERR_IO -2              /*!< a bus transaction failed */
+#define UFIRE_EC_ERR_NOT_CONNECTED -3   /*!< nothing answered at the address */
+#define UFIRE_EC_ERR_ARG -4             /*!< invalid handle or argument */
+
+typedef struct ufire_ec ufire_ec;       /*!< opaque device handle */
+
+typedef struct ufire_ec_reading         /*! One complete set of measured values */
+{
+  uint32_t sequence;                    /*!< increases with every reading, 0 if none yet */
+  float    mS;                          /*!< EC in milli-Siemens, -1 if not measured */
+  float    raw;                         /*!< raw EC count */
+  float    salinityPSU;                 /*!< salinity in practical salinity units */
+  float    tempC;                       /*!< temperature in C */
+} ufire_ec_reading;
+
+typedef struct ufire_ec_bus_stats      /*! Bus activity since the handle was opened */
+{
+  uint32_t transactions;                /*!< I2C transfers, reads and writes */
+  uint32_t errors;                      /*!< transfers that failed */
+  uint64_t bus_us;                      /*!< microseconds spent in transfers */
+} ufire_ec_bus_stats;
+
+typedef struct ufire_ec_calibration     /*! Calibration stored on the device */
+{
+  float refLow;                         /*!< low reference solution in mS */
+  float refHigh;                        /*!< high reference solution in mS */
+  float readLow;                        /*!< reading in the low solution */
+  float readHigh;                       /*!< reading in the high solution */
+  float offset;                         /*!< single point offset */
+} ufire_ec_calibration;
+
+int         ufire_ec_abi_version(void);
+const char *ufire_ec_strerror(int error);
+
+ufire_ec   *ufire_ec_open(int bus, uint8_t address, int *error);
+ufire_ec   *ufire_ec_open_device(const char *device, uint8_t address, int *error);
+ufire_ec   *ufire_ec_open_replay(const char *capture, uint8_t address, int latency, int *error);
+void        ufire_ec_close(ufire_ec *ec);
+int         ufire_ec_connected(ufire_ec *ec);
+
+int         ufire_ec_measure_ec(ufire_ec *ec, float temp, float temp_constant, float *mS);
+int         ufire_ec_measure_temp(ufire_ec *ec, float *tempC);
+int         ufire_ec_snapshot(ufire_ec *ec, ufire_ec_reading *reading);
+
+int         ufire_ec_calibrate(ufire_ec *ec, float solutionEC, float tempC, float *offset);
+int         ufire_ec_calibrate_low(ufire_ec *ec, float solutionEC, float tempC, float *reading);
+int         ufire_ec_calibrate_high(ufire_ec *ec, float solutionEC, float tempC, float *reading);
+int         ufire_ec_set_dual_point(ufire_ec *ec, float refLow, float refHigh, float readLow, float readHigh);
+int         ufire_ec_get_calibration(ufire_ec *ec, ufire_ec_calibration *calibration);
+int         ufire_ec_set_offset(ufire_ec *ec, float offset);
+int         ufire_ec_reset(ufire_ec *ec);
+
+int         ufire_ec_set_temp_coefficient(ufire_ec *ec, float tempCoef);
+int         ufire_ec_get_temp_coefficient(ufire_ec *ec, float *tempCoef);
+int         ufire_ec_set_temp_constant(ufire_ec *ec, float tempConstant);
+int         ufire_ec_get_temp_constant(ufire_ec *ec, float *tempConstant);
+int         ufire_ec_set_temp(ufire_ec *ec, float tempC);
+int         ufire_ec_use_temp_compensation(ufire_ec *ec, int enable);
+int         ufire_ec_version(ufire_ec *ec, uint8_t *hardware, uint8_t *firmware);
+int         ufire_ec_set_address(ufire_ec *ec, uint8_t address);
+int         ufire_ec_read_eeprom(ufire_ec *ec, uint8_t address, float *value);
+int         ufire_ec_write_eeprom(ufire_ec *ec, uint8_t address, float value);
+int         ufire_ec_read_data(ufire_ec *ec);
+int         ufire_ec_set_blocking(ufire_ec *ec, int blocking);
+int         ufire_ec_get_blocking(ufire_ec *ec, int *blocking);
+
+int         ufire_ec_record(ufire_ec *ec, const char *capture);
+int         ufire_ec_bus_stats_get(ufire_ec *ec, ufire_ec_bus_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ifndef UFIRE_EC_C_H
@@ -0,0 +1,257 @@
+# uFire_EC backed by libufire_ec.so, the C++ library built from ../../linux.
+# Same methods and fields as uFire_EC.py, so scripts only change the import:
+#   from uFire_EC_lib import uFire_EC
+
+import ctypes
+import ctypes.util
+import math
+import os
+
+EC_SALINITY = 0x3c                  # EC Salinity probe I2C address
+UFIRE_EC_ABI_VERSION = 1            # ABI this module was written for
+
+
+class uFire_EC_Error(Exception):
+    pass
+
+
+class _Reading(ctypes.Structure):
+    _fields_ = [('sequence', ctypes.c_uint32),
+                ('mS', ctypes.c_float),
+                ('raw', ctypes.c_float),
+                ('salinityPSU', ctypes.c_float),
+                ('tempC', ctypes.c_float)]
+
+
+class _BusStats(ctypes.Structure):
+    _fields_ = [('transactions', ctypes.c_uint32),
+                ('errors', ctypes.c_uint32),
+                ('bus_us', ctypes.c_uint64)]
+
+
+class _Calibration(ctypes.Structure):
+    _fields_ = [('refLow', ctypes.c_float),
+                ('refHigh', ctypes.c_float),
+                ('readLow', ctypes.c_float),
+                ('readHigh', ctypes.c_float),
+                ('offset', ctypes.c_float)]
+
+
+def _load():
+    here = os.path.dirname(os.path.abspath(__file__))
+    local = os.path.join(here, '..', '..', 'linux', 'build', 'libufire_ec.so')
+    path = local if os.path.exists(local) else ctypes.util.find_library('ufire_ec')
+    if not path:
+        raise OSError('libufire_ec.so not found, run make in the linux folder')
+
+    lib = ctypes.CDLL(path)
+    lib.ufire_ec_open.restype = ctypes.c_void_p
+    lib.ufire_ec_open.argtypes = [ctypes.c_int, ctypes.c_uint8, ctypes.POINTER(ctypes.c_int)]
+    lib.ufire_ec_open_replay.restype = ctypes.c_void_p
+    lib.ufire_ec_open_replay.argtypes = [ctypes.c_char_p, ctypes.c_uint8, ctypes.c_int,
+                                         ctypes.POINTER(ctypes.c_int)]
+    lib.ufire_ec_close.argtypes = [ctypes.c_void_p]
+    lib.ufire_ec_strerror.restype = ctypes.c_char_p
+    for name in ('connected', 'measure_ec', 'measure_temp', 'snapshot', 'calibrate',
+                 'calibrate_low', 'calibrate_high', 'set_dual_point', 'get_calibration',
+                 'reset', 'set_temp_coefficient', 'get_temp_coefficient',
+                 'set_temp_constant', 'get_temp_constant', 'version', 'record',
+                 'bus_stats_get', 'set_offset', 'set_temp', 'use_temp_compensation',
+                 'set_address', 'read_eeprom', 'write_eeprom', 'read_data',
+                 'set_blocking', 'get_blocking'):
+        getattr(lib, 'ufire_ec_' + name).restype = ctypes.c_int
+    if lib.ufire_ec_abi_version() != UFIRE_EC_ABI_VERSION:
+        raise OSError('libufire_ec.so has an incompatible ABI')
+    return lib
+
+
+_lib = _load()
+_f = ctypes.c_float
+
+
+class uFire_EC(object):
+    S = 0
+    mS = 0
+    uS = 0
+    raw = 0
+    PPM_500 = 0
+    PPM_640 = 0
+    PPM_700 = 0
+    salinityPSU = 0
+    tempC = 0
+    tempF = 0
+    address = EC_SALINITY
+    tempCoefEC = 0.019
+    tempCoefSalinity = 0.021
+
+    def __init__(self, address=EC_SALINITY, i2c_bus=3, replay=None, latency=False, **kwargs):
+        error = ctypes.c_int()
+        self.address = address
+        if replay:
+            self._h = _lib.ufire_ec_open_replay(replay.encode(), address, int(latency),
+                                                ctypes.byref(error))
+        else:
+            self._h = _lib.ufire_ec_open(i2c_bus, address, ctypes.byref(error))
+        if not self._h:
+            raise uFire_EC_Error(_lib.ufire_ec_strerror(error.value).decode())
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        if getattr(self, '_h', None):
+            _lib.ufire_ec_close(self._h)
+            self._h = None
+
+    def _call(self, name, *args):
+        err = getattr(_lib, 'ufire_ec_' + name)(ctypes.c_void_p(self._h), *args)
+        if err != 0:
+            raise uFire_EC_Error(_lib.ufire_ec_strerror(err).decode())
+
+    def _get(self, name, *args):
+        v = ctypes.c_float()
+        self._call(name, *(args + (ctypes.byref(v),)))
+        return v.value
+
+    def _update(self):
+        r = self.snapshot()
+        self.mS = r.mS
+        self.S = -1 if r.mS < 0 else r.mS / 1000
+        self.uS = -1 if r.mS < 0 else r.mS * 1000
+        self.PPM_500 = -1 if r.mS < 0 else self.uS * 0.5
+        self.PPM_640 = -1 if r.mS < 0 else self.uS * 0.64
+        self.PPM_700 = -1 if r.mS < 0 else self.uS * 0.70
+        self.raw = r.raw
+        self.salinityPSU = r.salinityPSU
+        self.tempC = r.tempC
+        self.tempF = -127 if r.tempC == -127 else ((r.tempC * 9) / 5) + 32
+
+# measurements
+    def measureEC(self, temp=25, temp_constant=25):
+        self._get('measure_ec', _f(temp), _f(temp_constant))
+        self._update()
+        return self.mS
+
+    def measureTemp(self):
+        self._get('measure_temp')
+        self._update()
+        return self.tempC
+
+    def snapshot(self):
+        r = _Reading()
+        self._call('snapshot', ctypes.byref(r))
+        return r
+
+# calibration
+    def calibrateProbe(self, solutionEC, tempC=25):
+        return self._get('calibrate', _f(solutionEC), _f(tempC))
+
+    def calibrateProbeLow(self, solutionEC, tempC=25):
+        return self._get('calibrate_low', _f(solutionEC), _f(tempC))
+
+    def calibrateProbeHigh(self, solutionEC, tempC=25):
+        return self._get('calibrate_high', _f(solutionEC), _f(tempC))
+
+    def setDualPointCalibration(self, refLow, refHigh, readLow, readHigh):
+        self._call('set_dual_point', _f(refLow), _f(refHigh), _f(readLow), _f(readHigh))
+
+    def getCalibration(self):
+        c = _Calibration()
+        self._call('get_calibration', ctypes.byref(c))
+        return c
+
+    def getCalibrateOffset(self):
+        return self.getCalibration().offset
+
+    def getCalibrateHighReference(self):
+        return self.getCalibration().refHigh
+
+    def getCalibrateLowReference(self):
+        return self.getCalibration().refLow
+
+    def getCalibrateHighReading(self):
+        return self.getCalibration().readHigh
+
+    def getCalibrateLowReading(self):
+        return self.getCalibration().readLow
+
+    def setCalibrateOffset(self, offset):
+        self._call('set_offset', _f(offset))
+
+# temperature
+    def setTemp(self, temp_C):
+        self._call('set_temp', _f(temp_C))
+        self.tempC = temp_C
+        self.tempF = ((self.tempC * 9) / 5) + 32
+
+    def setTempConstant(self, b):
+        self._call('set_temp_constant', _f(b))
+
+    def getTempConstant(self):
+        return self._get('get_temp_constant')
+
+    def setTempCoefficient(self, temp_coef):
+        self._call('set_temp_coefficient', _f(temp_coef))
+
+    def getTempCoefficient(self):
+        return self._get('get_temp_coefficient')
+
+    def useTemperatureCompensation(self, b):
+        self._call('use_temp_compensation', int(bool(b)))
+
+# utilities
+    def getVersion(self):
+        hw = ctypes.c_uint8()
+        self._call('version', ctypes.byref(hw), None)
+        return hw.value
+
+    def getFirmware(self):
+        fw = ctypes.c_uint8()
+        self._call('version', None, ctypes.byref(fw))
+        return fw.value
+
+    def reset(self):
+        self._call('reset')
+
+    def setI2CAddress(self, i2cAddress):
+        if i2cAddress >= 1 and i2cAddress <= 127:
+            self._call('set_address', int(i2cAddress))
+            self.address = int(i2cAddress)
+
+    def connected(self):
+        return _lib.ufire_ec_connected(ctypes.c_void_p(self._h)) == 0
+
+    def readEEPROM(self, address):
+        return self._get('read_eeprom', int(address))
+
+    def writeEEPROM(self, address, val):
+        self._call('write_eeprom', int(address), _f(float(val)))
+
+    def setBlocking(self, blocking):
+        if blocking in ('0', '1'):
+            self._call('set_blocking', int(blocking))
+
+    def getBlocking(self):
+        b = ctypes.c_int()
+        self._call('get_blocking', ctypes.byref(b))
+        return bool(b.value)
+
+    def readData(self):
+        self._call('read_data')
+        self._update()
+
+    def record(self, path=None):
+        self._call('record', path.encode() if path else None)
+
+    def busStats(self):
+        s = _BusStats()
+        self._call('bus_stats_get', ctypes.byref(s))
+        return s
+
+    def magnitude(self, x):
+        if math.isnan(x):
+            return 0
+        return 0 if x == 0 else int(math.floor(math.log10(abs(x)))) + 1
+
+    def round_total_digits(self, x, digits=7):
+        return round(x, digits - self.magnitude(x))
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Summarize and compare I2C captures made by libufire_ec.
+
+Record a session with ufire_ec_record() (or TwoWire::record() on Linux),
+run the same calls against ufire_ec_open_replay() with another build of
+the library while recording again, then:
+
+    python3 i2c_capture.py summary session.bin
+    python3 i2c_capture.py compare session.bin replayed.bin [tolerance]
+
+compare prints both summaries side by side and exits with status 1 when
+the second capture needs more transactions, or more bus time than the
+first by more than tolerance (a fraction, default 0.1).
+"""
+import struct
+import sys
+
+MAGIC = b"UECI"
+VERSION = 2
+READ = 0x01
+HEADER = struct.Struct("<BBBIH")
+
+
+def records(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != MAGIC or len(data) < 5 or data[4] != VERSION:
+        raise ValueError("%s is not a version %d capture" % (path, VERSION))
+
+    pos = 5
+    while pos + HEADER.size <= len(data):
+        flags, address, length, time, duration = HEADER.unpack_from(data, pos)
+        pos += HEADER.size
+        status = flags >> 4
+        payload = b""
+        # writes always carry their bytes, reads only when they succeeded
+        if status == 0 or not flags & READ:
+            payload = data[pos:pos + length]
+            pos += length
+        yield {
+            "read": bool(flags & READ),
+            "status": status,
+            "address": address,
+            "length": length,
+            "time": time,
+            "duration": duration,
+            "data": payload,
+        }
+
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p * len(values)))]
+
+
+def summarize(path):
+    reads = writes = nacks = errors = read_bytes = write_bytes = 0
+    durations = []
+    first = last = None
+    for r in records(path):
+        if r["read"]:
+            reads += 1
+            read_bytes += len(r["data"])
+        else:
+            writes += 1
+            if r["status"] == 0:
+                write_bytes += len(r["data"])
+        if r["status"] == 2:
+            nacks += 1
+        elif r["status"]:
+            errors += 1
+        durations.append(r["duration"])
+        first = r["time"] if first is None else first
+        last = r["time"] + r["duration"]
+    return {
+        "transactions": reads + writes,
+        "reads": reads,
+        "writes": writes,
+        "read bytes": read_bytes,
+        "write bytes": write_bytes,
+        "nacks": nacks,
+        "errors": errors,
+        "bus us": sum(durations),
+        "p50 us": percentile(durations, 0.5),
+        "p99 us": percentile(durations, 0.99),
+        "max us": max(durations) if durations else 0,
+        "session us": (last - first) if durations else 0,
+    }
+
+
+def main():
+    if len(sys.argv) < 3 or sys.argv[1] not in ("summary", "compare"):
+        print("usage: i2c_capture.py summary <capture>")
+        print("       i2c_capture.py compare <baseline> <candidate> [tolerance]")
+        sys.exit(2)
+
+    if sys.argv[1] == "summary":
+        for key, value in summarize(sys.argv[2]).items():
+            print("%-14s %d" % (key, value))
+        return
+
+    if len(sys.argv) < 4:
+        print("compare needs a baseline and a candidate capture")
+        sys.exit(2)
+    tolerance = float(sys.argv[4]) if len(sys.argv) > 4 else 0.1
+    a = summarize(sys.argv[2])
+    b = summarize(sys.argv[3])
+    print("%-14s %12s %12s %8s" % ("", "baseline", "candidate", "change"))
+    for key in a:
+        change = "" if a[key] == 0 else "%+.0f%%" % (100.0 * (b[key] - a[key]) / a[key])
+        print("%-14s %12d %12d %8s" % (key, a[key], b[key], change))
+
+    worse = b["transactions"] > a["transactions"] or \
+        b["bus us"] > a["bus us"] * (1 + tolerance)
+    if worse:
+        print("regression")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
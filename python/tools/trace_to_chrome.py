@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Convert a uFire_EC_Trace::dump() capture into Chrome trace JSON.
+
+Build the library with -DUFIRE_EC_TRACE, call uFire_EC_Trace::dump(Serial)
+and save the serial output to a file, then:
+
+    python3 trace_to_chrome.py capture.txt trace.json
+
+Open trace.json in chrome://tracing or https://ui.perfetto.dev. Each probe
+address gets its own track.
+"""
+import json
+import sys
+
+PHASES = [
+    "write register",
+    "write byte",
+    "_send_command",
+    "conversion",
+    "read register",
+    "read byte",
+    "_updateRegisters",
+    "processJSON",
+    "processMP",
+]
+
+
+def convert(lines):
+    events = []
+    last = None
+    offset = 0
+    for line in lines:
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        try:
+            us, phase, address, mark = line.split(",")
+            us, phase, address = int(us), int(phase), int(address)
+        except ValueError:
+            continue  # skip anything else the sketch printed
+
+        # micros() wraps every ~71 minutes
+        if last is not None and us + offset < last:
+            offset += 1 << 32
+        last = us + offset
+
+        name = PHASES[phase] if phase < len(PHASES) else "phase %d" % phase
+        events.append({
+            "name": name,
+            "ph": "B" if mark == "B" else "E",
+            "ts": last,
+            "pid": 1,
+            "tid": "0x%02x" % address if address else "library",
+        })
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: trace_to_chrome.py <capture.txt> [trace.json]")
+        sys.exit(1)
+
+    with open(sys.argv[1]) as f:
+        trace = convert(f)
+
+    out = open(sys.argv[2], "w") if len(sys.argv) > 2 else sys.stdout
+    json.dump(trace, out, indent=1)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,148 +1,329 @@
 #include "uFire_EC.h"
+#include "uFire_EC_Trace.h"
 
 const float uFire_EC::tempCoefEC       = 0.019;
 const float uFire_EC::tempCoefSalinity = 0.021;
+uFire_EC   *uFire_EC::_clocked         = nullptr;
 
-bool uFire_EC::begin(uint8_t address, TwoWire &wirePort)
+uFire_EC::~uFire_EC()
 {
+  _unlink_clock();
+}
+
+bool uFire_EC::begin(uint8_t address, TwoWire &wirePort, uint32_t maxClock)
+{
+  _unlink_clock();
   _address = address;
   _i2cPort = &wirePort;
   _ec_delay = 750;
 
+  if (maxClock)
+  {
+    return _negotiate_clock(maxClock) != 0;
+  }
+
   return connected();
 }
 
 float uFire_EC::measureEC(float temp, float temp_constant)
 {
-  setTemp(temp);
-  useTemperatureCompensation(true);
-  setTempConstant(temp_constant);
-  _send_command(EC_MEASURE_EC);
+  startEC(temp, temp_constant);
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
   if(_blocking) delay(_ec_delay);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
 
   _updateRegisters();
 
-  return mS;
+  return _reading.mS();
 }
 
 float uFire_EC::measureTemp()
 {
-  _send_command(EC_MEASURE_TEMP);
+  startTemp();
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
+  if(_blocking) delay(EC_TEMP_MEASURE_TIME);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
+
+  _updateRegisters();
+
+  return _reading.tempC();
+}
+
+long uFire_EC::measureEC_uS(int16_t temp_centi, int16_t temp_constant_centi)
+{
+  startEC_centi(temp_centi, temp_constant_centi);
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
+  if(_blocking) delay(_ec_delay);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
+
+  _updateRegisters();
+
+  return _reading.uS();
+}
+
+int16_t uFire_EC::measureTemp_centi()
+{
+  startTemp();
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
   if(_blocking) delay(EC_TEMP_MEASURE_TIME);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
 
   _updateRegisters();
 
-  return tempC;
+#if defined(UFIRE_EC_FIXED_POINT)
+  return _reading.tempC_centi();
+#else // if defined(UFIRE_EC_FIXED_POINT)
+  float    tempC = _reading.tempC();
+  uint32_t bits;
+  memcpy(&bits, &tempC, sizeof(bits));
+  return _centi(bits);
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+}
+
+void uFire_EC::startEC(float temp, float temp_constant)
+{
+  uFire_EC_Writes writes;
+
+  // config and task are adjacent, so the command rides with the config write
+  _stage_temp(writes, temp);
+  writes.stage<EC_Reg_TempCompensation>(temp_constant);
+  writes.stage<EC_Reg_Config>(_config(EC_TEMP_COMPENSATION_CONFIG_BIT, true));
+  writes.stage<EC_Reg_Task>(EC_MEASURE_EC);
+  flush(writes);
+  _pending = EC_MEASURE_EC;
+}
+
+void uFire_EC::startEC_centi(int16_t temp_centi, int16_t temp_constant_centi)
+{
+  uFire_EC_Writes writes;
+
+  // the registers hold floats, so build their bit patterns with integer math
+  uint32_t constant = fromFixed(temp_constant_centi, 100);
+
+  _stage_temp_bits(writes, fromFixed(temp_centi, 100));
+  writes.stageBytes(EC_Reg_TempCompensation::offset, &constant, sizeof(constant));
+  writes.stage<EC_Reg_Config>(_config(EC_TEMP_COMPENSATION_CONFIG_BIT, true));
+  writes.stage<EC_Reg_Task>(EC_MEASURE_EC);
+  flush(writes);
+  _pending = EC_MEASURE_EC;
+}
+
+void uFire_EC::startTemp()
+{
+  _send_command(EC_MEASURE_TEMP);
+  _pending = EC_MEASURE_TEMP;
+}
+
+void uFire_EC::readMeasurement()
+{
+  _updateRegisters();
+}
+
+int16_t uFire_EC::getMeasureTime()
+{
+  return _ec_delay;
+}
+
+const uFire_EC_Reading &uFire_EC::getReading()
+{
+  return _reading;
+}
+
+void uFire_EC::addListener(uFire_EC_Listener *listener)
+{
+  removeListener(listener);
+  listener->_next = _listeners;
+  _listeners      = listener;
+}
+
+void uFire_EC::removeListener(uFire_EC_Listener *listener)
+{
+  for (uFire_EC_Listener **l = &_listeners; *l; l = &(*l)->_next)
+  {
+    if (*l == listener)
+    {
+      *l = listener->_next;
+      listener->_next = nullptr;
+      return;
+    }
+  }
 }
 
 void uFire_EC::setTemp(float temp_C)
 {
-  _write_register(EC_TEMP_REGISTER, temp_C);
-  tempC = temp_C;
-  tempF = ((tempC * 9) / 5) + 32;
+  uFire_EC_Writes writes;
+
+  _stage_temp(writes, temp_C);
+  flush(writes);
+}
+
+void uFire_EC::_stage_temp(uFire_EC_Writes &writes, float temp_C)
+{
+  uint32_t bits;
+
+  memcpy(&bits, &temp_C, sizeof(bits));
+  _stage_temp_bits(writes, bits);
+}
+
+void uFire_EC::_stage_temp_bits(uFire_EC_Writes &writes, uint32_t bits)
+{
+  writes.stageBytes(EC_Reg_Temp::offset, &bits, sizeof(bits));
+#if defined(UFIRE_EC_FIXED_POINT)
+  _reading._tempC_centi = _centi(bits);
+#else
+  memcpy(&_reading._tempC, &bits, sizeof(bits));
+#endif
+#if UFIRE_EC_LEGACY_FIELDS
+  _update_legacy();
+#endif
+}
+
+int16_t uFire_EC::_centi(uint32_t bits)
+{
+  int32_t v = toFixed(bits, 100);
+
+  // a missing sensor reads NaN; report it the way the firmware reports -127 C
+  if ((v == EC_FIXED_NAN) || (v < -32768) || (v > 32767)) return -12700;
+  return v;
 }
 
 float uFire_EC::calibrateProbe(float solutionEC, float tempC)
 {
+  uFire_EC_Writes writes;
+
   solutionEC = _mS_to_mS25(solutionEC, tempC);
-  _write_register(EC_SOLUTION_REGISTER, solutionEC);
-  _send_command(EC_CALIBRATE_PROBE);
+  writes.stage<EC_Reg_Solution>(solutionEC);
+  writes.stage<EC_Reg_Task>(EC_CALIBRATE_PROBE);
+  flush(writes);
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
   if(_blocking) delay(_ec_delay);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
 
   return getCalibrateOffset();
 }
 
 float uFire_EC::calibrateProbeLow(float solutionEC, float tempC)
 {
+  uFire_EC_Writes writes;
+
   solutionEC = _mS_to_mS25(solutionEC, tempC);
-  _write_register(EC_SOLUTION_REGISTER, solutionEC);
-  _send_command(EC_CALIBRATE_LOW);
+  writes.stage<EC_Reg_Solution>(solutionEC);
+  writes.stage<EC_Reg_Task>(EC_CALIBRATE_LOW);
+  flush(writes);
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
   if(_blocking) delay(_ec_delay);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
 
   return getCalibrateLowReading();
 }
 
 float uFire_EC::calibrateProbeHigh(float solutionEC, float tempC)
 {
+  uFire_EC_Writes writes;
+
   solutionEC = _mS_to_mS25(solutionEC, tempC);
-  _write_register(EC_SOLUTION_REGISTER, solutionEC);
-  _send_command(EC_CALIBRATE_HIGH);
+  writes.stage<EC_Reg_Solution>(solutionEC);
+  writes.stage<EC_Reg_Task>(EC_CALIBRATE_HIGH);
+  flush(writes);
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, _address);
   if(_blocking) delay(_ec_delay);
+  EC_TRACE_END(EC_TRACE_CONVERSION, _address);
 
   return getCalibrateHighReading();
 }
 
 void uFire_EC::setDualPointCalibration(float refLow, float refHigh, float readLow, float readHigh)
 {
-  _write_register(EC_CALIBRATE_REFLOW_REGISTER,   refLow);
-  _write_register(EC_CALIBRATE_REFHIGH_REGISTER,  refHigh);
-  _write_register(EC_CALIBRATE_READLOW_REGISTER,  readLow);
-  _write_register(EC_CALIBRATE_READHIGH_REGISTER, readHigh);
+  uFire_EC_Burst<EC_Reg_CalibrateRefHigh, EC_Reg_CalibrateRefLow,
+                 EC_Reg_CalibrateReadHigh, EC_Reg_CalibrateReadLow> calibration;
+
+  calibration.set<EC_Reg_CalibrateRefLow>(refLow);
+  calibration.set<EC_Reg_CalibrateRefHigh>(refHigh);
+  calibration.set<EC_Reg_CalibrateReadLow>(readLow);
+  calibration.set<EC_Reg_CalibrateReadHigh>(readHigh);
+  write(calibration);
 }
 
 float uFire_EC::getCalibrateOffset()
 {
-  return _read_register(EC_CALIBRATE_OFFSET_REGISTER);
+  return read<EC_Reg_CalibrateOffset>();
 }
 
 float uFire_EC::getCalibrateHighReference()
 {
-  return _read_register(EC_CALIBRATE_REFHIGH_REGISTER);
+  return read<EC_Reg_CalibrateRefHigh>();
 }
 
 float uFire_EC::getCalibrateLowReference()
 {
-  return _read_register(EC_CALIBRATE_REFLOW_REGISTER);
+  return read<EC_Reg_CalibrateRefLow>();
 }
 
 float uFire_EC::getCalibrateHighReading()
 {
-  return _read_register(EC_CALIBRATE_READHIGH_REGISTER);
+  return read<EC_Reg_CalibrateReadHigh>();
 }
 
 float uFire_EC::getCalibrateLowReading()
 {
-  return _read_register(EC_CALIBRATE_READLOW_REGISTER);
+  return read<EC_Reg_CalibrateReadLow>();
 }
 
 void uFire_EC::useTemperatureCompensation(bool b)
+{
+  write<EC_Reg_Config>(_config(EC_TEMP_COMPENSATION_CONFIG_BIT, b));
+}
+
+uint8_t uFire_EC::_config(uint8_t bit, bool b)
 {
   uint8_t retval;
-  uint8_t config = _read_byte(EC_CONFIG_REGISTER);
+  uint8_t config = read<EC_Reg_Config>();
 
   if (b)
   {
-    retval = bitSet(config, EC_TEMP_COMPENSATION_CONFIG_BIT);
+    retval = bitSet(config, bit);
   }
   else
   {
-    retval = bitClear(config, EC_TEMP_COMPENSATION_CONFIG_BIT);
+    retval = bitClear(config, bit);
   }
 
-  _write_byte(EC_CONFIG_REGISTER, retval);
+  return retval;
 }
 
 uint8_t uFire_EC::getVersion()
 {
-  return _read_byte(EC_VERSION_REGISTER);
+  return read<EC_Reg_Version>();
 }
 
 uint8_t uFire_EC::getFirmware()
 {
-  return _read_byte(EC_FW_VERSION_REGISTER);
+  return read<EC_Reg_Firmware>();
+}
+
+uint32_t uFire_EC::getClock()
+{
+  return _clock;
+}
+
+uint16_t uFire_EC::getTransactionTime()
+{
+  return _transaction_us;
 }
 
 void uFire_EC::reset()
 {
-  _write_register(EC_CALIBRATE_OFFSET_REGISTER, NAN);
+  // each register gets its own write and settle time, as the firmware
+  // documents no limit for merged writes that persist settings
+  write<EC_Reg_CalibrateOffset>(NAN);
   delay(10);
-  _write_register(EC_CALIBRATE_REFHIGH_REGISTER, NAN);
+  write<EC_Reg_CalibrateRefHigh>(NAN);
   delay(10);
-  _write_register(EC_CALIBRATE_REFLOW_REGISTER, NAN);
+  write<EC_Reg_CalibrateRefLow>(NAN);
   delay(10);
-  _write_register(EC_CALIBRATE_READHIGH_REGISTER, NAN);
+  write<EC_Reg_CalibrateReadHigh>(NAN);
   delay(10);
-  _write_register(EC_CALIBRATE_READLOW_REGISTER, NAN);
+  write<EC_Reg_CalibrateReadLow>(NAN);
   delay(10);
   setTempConstant(25.0);
   delay(10);
@@ -153,23 +334,26 @@ void uFire_EC::reset()
 
 void uFire_EC::setCalibrateOffset(float offset)
 {
-  _write_register(EC_CALIBRATE_OFFSET_REGISTER, offset);
+  write<EC_Reg_CalibrateOffset>(offset);
 }
 
 void uFire_EC::setTempConstant(float b)
 {
-  _write_register(EC_TEMP_COMPENSATION_REGISTER, b);
+  write<EC_Reg_TempCompensation>(b);
 }
 
 float uFire_EC::getTempConstant()
 {
-  return _read_register(EC_TEMP_COMPENSATION_REGISTER);
+  return read<EC_Reg_TempCompensation>();
 }
 
 void uFire_EC::setI2CAddress(uint8_t i2cAddress)
 {
-  _write_register(EC_SOLUTION_REGISTER, i2cAddress);
-  _send_command(EC_I2C);
+  uFire_EC_Writes writes;
+
+  writes.stage<EC_Reg_Solution>(i2cAddress);
+  writes.stage<EC_Reg_Task>(EC_I2C);
+  flush(writes);
   _address = i2cAddress;
 }
 
@@ -177,7 +361,7 @@ bool uFire_EC::connected()
 {
   uint8_t retval;
 
-  retval = _read_byte(EC_VERSION_REGISTER);
+  retval = read<EC_Reg_Version>();
   if (retval != 0xFF) {
     return true;
   }
@@ -188,26 +372,32 @@ bool uFire_EC::connected()
 
 float uFire_EC::readEEPROM(uint8_t address)
 {
-  _write_register(EC_SOLUTION_REGISTER, address);
-  _send_command(EC_READ);
-  return _read_register(EC_BUFFER_REGISTER);
+  uFire_EC_Writes writes;
+
+  writes.stage<EC_Reg_Solution>(address);
+  writes.stage<EC_Reg_Task>(EC_READ);
+  flush(writes);
+  return read<EC_Reg_Buffer>();
 }
 
 void uFire_EC::writeEEPROM(uint8_t address, float value)
 {
-  _write_register(EC_SOLUTION_REGISTER, address);
-  _write_register(EC_BUFFER_REGISTER,   value);
-  _send_command(EC_WRITE);
+  uFire_EC_Writes writes;
+
+  writes.stage<EC_Reg_Solution>(address);
+  writes.stage<EC_Reg_Buffer>(value);
+  writes.stage<EC_Reg_Task>(EC_WRITE);
+  flush(writes);
 }
 
 void uFire_EC::setTempCoefficient(float temp_coef)
 {
-  _write_register(EC_TEMPCOEF_REGISTER, temp_coef);
+  write<EC_Reg_TempCoef>(temp_coef);
 }
 
 float uFire_EC::getTempCoefficient()
 {
-  return _read_register(EC_TEMPCOEF_REGISTER);
+  return read<EC_Reg_TempCoef>();
 }
 
 void uFire_EC::setBlocking(bool b)
@@ -220,14 +410,77 @@ bool uFire_EC::getBlocking()
     return _blocking;
 }
 
+bool uFire_EC_Writes::stageRegister(uint8_t reg, float f)
+{
+  return stageBytes(reg, &f, sizeof(f));
+}
+
+bool uFire_EC_Writes::stageByte(uint8_t reg, uint8_t val)
+{
+  return stageBytes(reg, &val, 1);
+}
+
+bool uFire_EC_Writes::stageBytes(uint8_t reg, const void *data, uint8_t len)
+{
+  uint8_t i;
+
+  if (len > sizeof(_slots[0].data)) return false;
+
+  // slots are kept in register order so flush() can merge adjacent ones
+  for (i = 0; i < _count; i++)
+  {
+    if ((_slots[i].reg == reg) && (_slots[i].len == len))
+    {
+      memcpy(_slots[i].data, data, len);
+      return true;
+    }
+    if (_slots[i].reg > reg) break;
+  }
+
+  if (_count == EC_WRITE_STAGE_SLOTS) return false;
+
+  memmove(&_slots[i + 1], &_slots[i], (_count - i) * sizeof(_slots[0]));
+  _slots[i].reg = reg;
+  _slots[i].len = len;
+  memcpy(_slots[i].data, data, len);
+  _count++;
+  return true;
+}
+
+uint8_t uFire_EC::flush(uFire_EC_Writes &writes, uint16_t settle_ms)
+{
+  uint8_t transactions = 0;
+  uint8_t i            = 0;
+  uint8_t buffer[EC_WRITE_BURST_MAX];
+
+  while (i < writes._count)
+  {
+    uint8_t start = writes._slots[i].reg;
+    uint8_t len   = 0;
+
+    while ((i < writes._count) && (writes._slots[i].reg == start + len) &&
+           (len + writes._slots[i].len <= EC_WRITE_BURST_MAX))
+    {
+      memcpy(&buffer[len], writes._slots[i].data, writes._slots[i].len);
+      len += writes._slots[i].len;
+      i++;
+    }
+    _write_bytes(start, buffer, len);
+    transactions++;
+    if (settle_ms) delay(settle_ms);
+  }
+
+  writes.clear();
+  return transactions;
+}
+
 void uFire_EC::readData()
 {
+  uFire_EC_Burst<EC_Reg_CalibrateRefHigh, EC_Reg_CalibrateRefLow, EC_Reg_CalibrateReadHigh,
+                 EC_Reg_CalibrateReadLow, EC_Reg_CalibrateOffset> calibration;
+
   _updateRegisters();
-  getCalibrateHighReading();
-  getCalibrateHighReference();
-  getCalibrateLowReading();
-  getCalibrateLowReference();
-  getCalibrateOffset();
+  read(calibration);
 }
 
 float uFire_EC::_mS_to_mS25(float mS, float tempC)
@@ -235,48 +488,158 @@ float uFire_EC::_mS_to_mS25(float mS, float tempC)
   return mS / (1 - (getTempCoefficient() * (tempC - 25)));
 }
 
-void uFire_EC::_updateRegisters()
+int32_t uFire_EC::toFixed(uint32_t bits, uint16_t scale)
 {
-  raw = _read_register(EC_RAW_REGISTER);
+  int16_t  e = (bits >> 23) & 0xFF;
+  uint32_t m;
+  int16_t  shift;
+
+  if (e == 0xFF) return EC_FIXED_NAN;
+  if (e == 0) return 0;
 
-  if (raw == 0.0)
+  // keep 16 significant bits so the product with a 16-bit scale fits 32 bits
+  m     = (((bits & 0x7FFFFF) | 0x800000) >> 8) * scale;
+  shift = 142 - e;
+  if (shift > 31) return 0;
+  if (shift > 0)
   {
-    mS = NAN; // make it NaN so the following statement will -1 everything
+    m = ((m >> (shift - 1)) + 1) >> 1;
   }
-  else
+  else if (shift < 0)
   {
-    mS = _read_register(EC_MS_REGISTER);
+    if ((-shift > 30) || (m > (0x7FFFFFFFUL >> -shift))) return EC_FIXED_NAN;
+    m <<= -shift;
   }
+  if (m > 0x7FFFFFFFUL) return EC_FIXED_NAN;
+
+  return (bits & 0x80000000UL) ? -(int32_t)m : (int32_t)m;
+}
+
+uint32_t uFire_EC::fromFixed(int32_t value, uint16_t scale)
+{
+  uint32_t n = value < 0 ? -(uint32_t)value : value;
+  uint32_t q, r;
+  int16_t  e = 150;
+  bool     half, sticky;
+
+  if ((n == 0) || (scale == 0)) return 0;
 
-  if (mS == mS)
+  // q holds the 24 significant bits at 2^(e - 150); the bits below decide rounding
+  q      = n / scale;
+  r      = n % scale;
+  half   = false;
+  sticky = r != 0;
+  if (q >= 0x1000000UL)
   {
-    PPM_500     = mS * 500;
-    PPM_640     = mS * 640;
-    PPM_700     = mS * 700;
-    uS          = mS * 1000;
-    S           = mS / 1000;
-    salinityPSU = _read_register(EC_SALINITY_PSU);
+    while (q >= 0x1000000UL)
+    {
+      sticky = sticky || half;
+      half   = q & 1;
+      q    >>= 1;
+      e++;
+    }
   }
   else
   {
-    mS          = -1;
-    PPM_500     = -1;
-    PPM_640     = -1;
-    PPM_700     = -1;
-    uS          = -1;
-    S           = -1;
-    salinityPSU = -1;
+    // long division one bit at a time
+    while (q < 0x800000UL)
+    {
+      q <<= 1;
+      r <<= 1;
+      if (r >= scale)
+      {
+        q |= 1;
+        r -= scale;
+      }
+      e--;
+    }
+    half   = 2 * r >= scale;
+    sticky = 2 * r != scale;
   }
 
-  tempC = _read_register(EC_TEMP_REGISTER);
-  if (tempC == -127.0)
+  // round to nearest, ties to even, as a float conversion would
+  if (half && (sticky || (q & 1)))
   {
-    tempF = -127;
+    if (++q == 0x1000000UL)
+    {
+      q >>= 1;
+      e++;
+    }
+  }
+
+  return (value < 0 ? 0x80000000UL : 0) | ((uint32_t)e << 23) | (q & 0x7FFFFFUL);
+}
+
+void uFire_EC::_updateRegisters()
+{
+  uFire_EC_Reading r;
+
+  EC_TRACE_BEGIN(EC_TRACE_UPDATE, _address);
+  r._measured = _pending;
+  _pending    = 0;
+
+#if defined(UFIRE_EC_FIXED_POINT)
+  r._raw = toFixed(_read_bits(EC_Reg_Raw::offset), 1);
+  r._uS  = r._raw == 0 ? EC_FIXED_NAN : toFixed(_read_bits(EC_Reg_MS::offset), 1000);
+
+  if (r._uS != EC_FIXED_NAN)
+  {
+    r._salinity_mPSU = toFixed(_read_bits(EC_Reg_Salinity::offset), 1000);
+  }
+
+  r._tempC_centi = _centi(_read_bits(EC_Reg_Temp::offset));
+#else // if defined(UFIRE_EC_FIXED_POINT)
+  r._raw = read<EC_Reg_Raw>();
+
+  if (r._raw == 0.0)
+  {
+    r._mS = NAN; // make it NaN so the accessors report -1 for everything
   }
   else
   {
-    tempF = ((tempC * 9) / 5) + 32;
+    r._mS = read<EC_Reg_MS>();
+  }
+
+  if (r._mS == r._mS)
+  {
+    r._salinityPSU = read<EC_Reg_Salinity>();
   }
+
+  r._tempC = read<EC_Reg_Temp>();
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+
+  _reading = r;
+#if UFIRE_EC_LEGACY_FIELDS
+  _update_legacy();
+#endif
+  EC_TRACE_END(EC_TRACE_UPDATE, _address);
+
+  for (uFire_EC_Listener *l = _listeners; l; l = l->_next)
+  {
+    l->onReading(*this, _reading);
+  }
+}
+
+void uFire_EC::_update_legacy()
+{
+#if UFIRE_EC_LEGACY_FIELDS
+  uS      = _reading.uS();
+  raw     = _reading.raw();
+  PPM_500 = _reading.PPM_500();
+  PPM_640 = _reading.PPM_640();
+  PPM_700 = _reading.PPM_700();
+# if defined(UFIRE_EC_FIXED_POINT)
+  salinity_mPSU = _reading.salinity_mPSU();
+  tempC_centi   = _reading.tempC_centi();
+  tempF_centi   = _reading.tempF_centi();
+# else // if defined(UFIRE_EC_FIXED_POINT)
+  S           = _reading.S();
+  mS          = _reading.mS();
+  salinityPSU = _reading.salinityPSU();
+  tempC       = _reading.tempC();
+  tempF       = _reading.tempF();
+# endif // if defined(UFIRE_EC_FIXED_POINT)
+#endif // if UFIRE_EC_LEGACY_FIELDS
 }
 
 void uFire_EC::_change_register(uint8_t r)
@@ -289,65 +652,166 @@ void uFire_EC::_change_register(uint8_t r)
 
 void uFire_EC::_send_command(uint8_t command)
 {
-  _i2cPort->beginTransmission(_address);
-  _i2cPort->write(EC_TASK_REGISTER);
-  _i2cPort->write(command);
-  _i2cPort->endTransmission();
-  //delay(10);
+  EC_TRACE_BEGIN(EC_TRACE_SEND_COMMAND, _address);
+  write<EC_Reg_Task>(command);
+  EC_TRACE_END(EC_TRACE_SEND_COMMAND, _address);
 }
 
-void uFire_EC::_write_register(uint8_t reg, float f)
+uint32_t uFire_EC::_read_bits(uint8_t reg)
 {
-  uint8_t b[5];
-  float   f_val = f;
+  uint8_t b[4];
 
-  b[0] = reg;
-  b[1] = *((uint8_t *)&f_val);
-  b[2] = *((uint8_t *)&f_val + 1);
-  b[3] = *((uint8_t *)&f_val + 2);
-  b[4] = *((uint8_t *)&f_val + 3);
-  _i2cPort->beginTransmission(_address);
-  _i2cPort->write(b, 5);
-  _i2cPort->endTransmission();
-  //delay(10);
+  _read_bytes(reg, b, 4);
+  return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
 }
 
-float uFire_EC::_read_register(uint8_t reg)
+void uFire_EC::_read_bytes(uint8_t reg, uint8_t *data, uint8_t len)
 {
-  float retval;
+#if defined(UFIRE_EC_TRACE)
+  uint8_t phase = len == 1 ? EC_TRACE_READ_BYTE : EC_TRACE_READ_REGISTER;
+#endif
 
+  // the firmware answers one byte per request and advances its pointer
+  EC_TRACE_BEGIN(phase, _address);
   _change_register(reg);
-  _i2cPort->requestFrom(_address, (uint8_t)1);
-  *((uint8_t *)&retval) = _i2cPort->read();
-  _i2cPort->requestFrom(_address, (uint8_t)1);
-  *((uint8_t *)&retval + 1) = _i2cPort->read();
-  _i2cPort->requestFrom(_address, (uint8_t)1);
-  *((uint8_t *)&retval + 2) = _i2cPort->read();
-  _i2cPort->requestFrom(_address, (uint8_t)1);
-  *((uint8_t *)&retval + 3) = _i2cPort->read();
+  for (uint8_t i = 0; i < len; i++)
+  {
+    _i2cPort->requestFrom(_address, (uint8_t)1);
+    data[i] = _i2cPort->read();
+  }
+  EC_TRACE_END(phase, _address);
   //delay(10);
-  return retval;
 }
 
-void uFire_EC::_write_byte(uint8_t reg, uint8_t val)
+void uFire_EC::_write_bytes(uint8_t reg, const uint8_t *data, uint8_t len)
 {
-  uint8_t b[5];
+#if defined(UFIRE_EC_TRACE)
+  uint8_t phase = len == 1 ? EC_TRACE_WRITE_BYTE : EC_TRACE_WRITE_REGISTER;
+#endif
 
-  b[0] = reg;
-  b[1] = val;
+  EC_TRACE_BEGIN(phase, _address);
   _i2cPort->beginTransmission(_address);
-  _i2cPort->write(b, 2);
+  _i2cPort->write(reg);
+  _i2cPort->write(data, len);
   _i2cPort->endTransmission();
+  EC_TRACE_END(phase, _address);
   //delay(10);
 }
 
-uint8_t uFire_EC::_read_byte(uint8_t reg)
+
+uint32_t uFire_EC::_negotiate_clock(uint32_t maxClock)
 {
-  uint8_t retval;
+  static const uint32_t steps[] = { 100000, 400000, 1000000 };
+  uint32_t limit   = maxClock < EC_MAX_CLOCK ? maxClock : EC_MAX_CLOCK;
+  uint32_t settled = 0;
+  uint8_t  expected[3];
 
-  _change_register(reg);
-  _i2cPort->requestFrom(_address, (uint8_t)1);
-  retval = _i2cPort->read();
-  //delay(10);
-  return retval;
-}
\ No newline at end of file
+  // the clock belongs to the bus: never go above a rate another probe on it
+  // already settled on
+  _clock = 0;
+  for (uFire_EC *ec = _clocked; ec; ec = ec->_clocked_next)
+  {
+    if ((ec->_i2cPort == _i2cPort) && (!settled || (ec->_clock < settled))) settled = ec->_clock;
+  }
+  if (settled && (settled < limit)) limit = settled;
+
+  // the slowest allowed rate gives the reference values every faster rate
+  // must reproduce
+  uint32_t base = limit < steps[0] ? limit : steps[0];
+  _set_clock(base);
+  if (!_readback(expected) || expected[0] == 0xFF || !_verify_clock(expected))
+  {
+    if (settled) _set_clock(settled);
+    return 0;
+  }
+  _clock = base;
+
+  for (uint8_t i = 1; i < sizeof(steps) / sizeof(steps[0]); i++)
+  {
+    if (steps[i] > limit) break;
+
+    uint16_t previous_us = _transaction_us;
+    _set_clock(steps[i]);
+    if (!_verify_clock(expected))
+    {
+      _set_clock(_clock);
+      _transaction_us = previous_us;
+      break;
+    }
+    _clock = steps[i];
+  }
+
+  // a probe that settled lower slowed the bus down for the others too
+  _clocked_next = _clocked;
+  _clocked      = this;
+  for (uFire_EC *ec = _clocked; ec; ec = ec->_clocked_next)
+  {
+    if (ec->_i2cPort == _i2cPort) ec->_clock = _clock;
+  }
+  return _clock;
+}
+
+bool uFire_EC::_verify_clock(const uint8_t *expected)
+{
+  uint8_t  ids[3];
+  uint32_t start = micros();
+
+  for (uint8_t i = 0; i < EC_CLOCK_VERIFY_ROUNDS; i++)
+  {
+    if (!_readback(ids)) return false;
+    if (memcmp(ids, expected, sizeof(ids)) != 0) return false;
+  }
+
+  // _readback() is two pointer writes and three reads per round
+  _transaction_us = (micros() - start) / (EC_CLOCK_VERIFY_ROUNDS * 5);
+  return true;
+}
+
+bool uFire_EC::_readback(uint8_t *ids)
+{
+  // version, then firmware and config which are adjacent
+  _i2cPort->beginTransmission(_address);
+  _i2cPort->write(EC_VERSION_REGISTER);
+  if (_i2cPort->endTransmission() != 0) return false;
+  if (!_read_byte_checked(&ids[0])) return false;
+
+  _i2cPort->beginTransmission(_address);
+  _i2cPort->write(EC_FW_VERSION_REGISTER);
+  if (_i2cPort->endTransmission() != 0) return false;
+  if (!_read_byte_checked(&ids[1])) return false;
+  return _read_byte_checked(&ids[2]);
+}
+
+bool uFire_EC::_read_byte_checked(uint8_t *val)
+{
+  if (_i2cPort->requestFrom(_address, (uint8_t)1) != 1) return false;
+
+  int b = _i2cPort->read();
+  if (b < 0) return false;
+  *val = b;
+  return true;
+}
+
+void uFire_EC::_unlink_clock()
+{
+  for (uFire_EC **ec = &_clocked; *ec; ec = &(*ec)->_clocked_next)
+  {
+    if (*ec == this)
+    {
+      *ec = _clocked_next;
+      break;
+    }
+  }
+  _clocked_next = nullptr;
+}
+
+void uFire_EC::_set_clock(uint32_t clock)
+{
+#if defined(PARTICLE)
+  _i2cPort->end();
+  _i2cPort->setSpeed(clock);
+  _i2cPort->begin();
+#else // if defined(PARTICLE)
+  _i2cPort->setClock(clock);
+#endif // if defined(PARTICLE)
+}
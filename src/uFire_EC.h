@@ -46,13 +46,166 @@
 #define EC_EC_MEASUREMENT_TIME 500        /*!< delay between EC measurements */
 #define EC_TEMP_MEASURE_TIME 750          /*!< delay for temperature measurement */
 
+#define EC_CLOCK_VERIFY_ROUNDS 8         /*!< readbacks that must match before a bus clock is kept */
+#if defined(__AVR__)
+# define EC_MAX_CLOCK 400000              /*!< fastest bus clock the platform supports */
+#else // if defined(__AVR__)
+# define EC_MAX_CLOCK 1000000             /*!< fastest bus clock the platform supports */
+#endif // if defined(__AVR__)
+
+#ifndef EC_WRITE_STAGE_SLOTS
+# define EC_WRITE_STAGE_SLOTS 8          /*!< register writes one uFire_EC_Writes holds */
+#endif // ifndef EC_WRITE_STAGE_SLOTS
+#define EC_WRITE_BURST_MAX 16             /*!< longest merged write in data bytes; with the register byte it fits a 32-byte Wire buffer */
+
+#define EC_FIXED_NAN ((int32_t)0x80000000) /*!< toFixed() result for NaN or infinity */
+
 #define EC_DUALPOINT_CONFIG_BIT 0         /*!< dual point config bit */
 #define EC_TEMP_COMPENSATION_CONFIG_BIT 1 /*!< temperature compensation config bit */
 
+#include "uFire_EC_Registers.h"
+
+#ifndef UFIRE_EC_LEGACY_FIELDS
+# define UFIRE_EC_LEGACY_FIELDS 1         /*!< keep the per-unit public result fields */
+#endif // ifndef UFIRE_EC_LEGACY_FIELDS
+
+// UFIRE_EC_FIXED_POINT and UFIRE_EC_LEGACY_FIELDS change the class layout, so
+// the classes live in an inline namespace named after the build options. A
+// sketch built with different options than the library then fails to link
+// with an undefined reference naming the options it expected.
+#if defined(UFIRE_EC_FIXED_POINT)
+# if UFIRE_EC_LEGACY_FIELDS
+#  define UFIRE_EC_CONFIG config_fixed_point_legacy_fields
+# else // if UFIRE_EC_LEGACY_FIELDS
+#  define UFIRE_EC_CONFIG config_fixed_point_no_legacy_fields
+# endif // if UFIRE_EC_LEGACY_FIELDS
+#else // if defined(UFIRE_EC_FIXED_POINT)
+# if UFIRE_EC_LEGACY_FIELDS
+#  define UFIRE_EC_CONFIG config_float_legacy_fields
+# else // if UFIRE_EC_LEGACY_FIELDS
+#  define UFIRE_EC_CONFIG config_float_no_legacy_fields
+# endif // if UFIRE_EC_LEGACY_FIELDS
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+
+inline namespace UFIRE_EC_CONFIG {
+
+class uFire_EC_Reading                    /*! Measured quantities of one update, derived units on demand */
+{
+public:
+
+  // EC_MEASURE_EC or EC_MEASURE_TEMP on the first update after that
+  // measurement, 0 when the registers were only read again
+  uint8_t measured() const    { return _measured; }
+
+#if defined(UFIRE_EC_FIXED_POINT)
+
+  // UFIRE_EC_FIXED_POINT, given as a compiler flag so the library sees it
+  // too, converts readings with integer math for FPU-less boards
+  bool    hasEC() const       { return _uS != EC_FIXED_NAN; }
+  long    uS() const          { return _uS == EC_FIXED_NAN ? -1 : _uS; }
+  long    raw() const         { return _raw; }
+  long    PPM_500() const     { return _uS == EC_FIXED_NAN ? -1 : _uS / 2; }
+  long    PPM_640() const     { return _uS == EC_FIXED_NAN ? -1 : (_uS * 16) / 25; }
+  long    PPM_700() const     { return _uS == EC_FIXED_NAN ? -1 : (_uS * 7) / 10; }
+  long    salinity_mPSU() const { return _uS == EC_FIXED_NAN ? -1 : _salinity_mPSU; }
+  int16_t tempC_centi() const { return _tempC_centi; }
+  int16_t tempF_centi() const { return _tempC_centi == -12700 ? -12700 : ((_tempC_centi * 9L) / 5) + 3200; }
+  float   S() const           { return _uS == EC_FIXED_NAN ? -1 : _uS / 1000000.0; }
+  float   mS() const          { return _uS == EC_FIXED_NAN ? -1 : _uS / 1000.0; }
+  float   salinityPSU() const { return _uS == EC_FIXED_NAN ? -1 : _salinity_mPSU / 1000.0; }
+  float   tempC() const       { return _tempC_centi / 100.0; }
+  float   tempF() const       { return tempF_centi() / 100.0; }
+#else // if defined(UFIRE_EC_FIXED_POINT)
+
+  // _mS is NaN when the probe reported no EC; only then are the results -1
+  bool    hasEC() const       { return _mS == _mS; }
+  float   S() const           { return _mS != _mS ? -1 : _mS / 1000; }
+  float   mS() const          { return _mS != _mS ? -1 : _mS; }
+  long    uS() const          { return _mS != _mS ? -1 : _mS * 1000; }
+  long    raw() const         { return _raw; }
+  long    PPM_500() const     { return _mS != _mS ? -1 : _mS * 500; }
+  long    PPM_640() const     { return _mS != _mS ? -1 : _mS * 640; }
+  long    PPM_700() const     { return _mS != _mS ? -1 : _mS * 700; }
+  float   salinityPSU() const { return _mS != _mS ? -1 : _salinityPSU; }
+  float   tempC() const       { return _tempC; }
+  float   tempF() const       { return _tempC == -127.0 ? -127 : ((_tempC * 9) / 5) + 32; }
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+
+private:
+
+  friend class uFire_EC;
+  uint8_t _measured = 0;
+#if defined(UFIRE_EC_FIXED_POINT)
+  long    _uS = EC_FIXED_NAN;
+  long    _raw = 0;
+  long    _salinity_mPSU = -1;
+  int16_t _tempC_centi = 0;
+#else // if defined(UFIRE_EC_FIXED_POINT)
+  float   _mS = NAN;
+  long    _raw = 0;
+  float   _salinityPSU = -1;
+  float   _tempC = 0;
+#endif // if defined(UFIRE_EC_FIXED_POINT)
+};
+
+class uFire_EC;
+
+class uFire_EC_Listener                   /*! Notified by uFire_EC after every complete reading */
+{
+public:
+
+  virtual void onReading(uFire_EC &ec, const uFire_EC_Reading &reading) = 0;
+
+private:
+
+  friend class uFire_EC;
+  uFire_EC_Listener *_next = nullptr;
+};
+
+class uFire_EC_Writes                     /*! Register writes collected for one uFire_EC::flush() */
+{
+public:
+
+  bool    stageRegister(uint8_t reg, float f);
+  bool    stageByte(uint8_t reg, uint8_t val);
+  bool    stageBytes(uint8_t reg, const void *data, uint8_t len);
+  uint8_t count() const { return _count; }
+  void    clear()       { _count = 0; }
+
+  template<class Reg>
+  bool stage(typename Reg::type v)
+  {
+    static_assert(Reg::access & EC_ACCESS_WRITE, "register is read-only");
+    return stageBytes(Reg::offset, &v, Reg::size);
+  }
+
+private:
+
+  friend class uFire_EC;
+  struct
+  {
+    uint8_t reg;
+    uint8_t len;
+    uint8_t data[4];
+  }       _slots[EC_WRITE_STAGE_SLOTS];
+  uint8_t _count = 0;
+};
+
 class uFire_EC                            /*! uFire_EC Class */
 {
 public:
 
+#if UFIRE_EC_LEGACY_FIELDS
+# if defined(UFIRE_EC_FIXED_POINT)
+  long uS;                             /*!< EC in micro-Siemens */
+  long raw;
+  long PPM_500;                        /*!< Parts per million using 500 as a multiplier */
+  long PPM_640;                        /*!< Parts per million using 640 as a multiplier */
+  long PPM_700;                        /*!< Parts per million using 700 as a multiplier */
+  long salinity_mPSU;                  /*!< Salinity in milli practical salinity units */
+  int16_t tempC_centi;                 /*!< Temperature in hundredths of a degree C */
+  int16_t tempF_centi;                 /*!< Temperature in hundredths of a degree F */
+# else // if defined(UFIRE_EC_FIXED_POINT)
   float S;                             /*!< EC in Siemens */
   float mS;                            /*!<Salinity EC in milli-Siemens */
   long uS;                            /*!< EC in micro-Siemens */
@@ -63,12 +216,25 @@ public:
   float salinityPSU;                   /*!< Salinity measured practical salinity units */
   float tempC;                         /*!< Temperature in C */
   float tempF;                         /*!< Temperature in F */
+# endif // if defined(UFIRE_EC_FIXED_POINT)
+#endif // if UFIRE_EC_LEGACY_FIELDS
   static const float tempCoefEC;       /*!< Temperature compensation coefficient for EC measurement */
   static const float tempCoefSalinity; /*!< Temperature compensation coefficient for salinity measurement */
 
-  bool    begin(uint8_t address=EC_SALINITY, TwoWire &wirePort=Wire);
+  ~uFire_EC();
+  bool    begin(uint8_t address=EC_SALINITY, TwoWire &wirePort=Wire, uint32_t maxClock=0);
   float   measureEC(float temp=25.0, float temp_constant=25.0);
   float   measureTemp();
+  long    measureEC_uS(int16_t temp_centi=2500, int16_t temp_constant_centi=2500);
+  int16_t measureTemp_centi();
+  void    startEC(float temp=25.0, float temp_constant=25.0);
+  void    startEC_centi(int16_t temp_centi=2500, int16_t temp_constant_centi=2500);
+  void    startTemp();
+  void    readMeasurement();
+  const uFire_EC_Reading &getReading();
+  void    addListener(uFire_EC_Listener *listener);
+  void    removeListener(uFire_EC_Listener *listener);
+  int16_t getMeasureTime();
   void    setTemp(float temp_C);
   float   calibrateProbe(float solutionEC, float tempC=25.0);
   float   calibrateProbeLow(float solutionEC, float tempC=25.0);
@@ -87,6 +253,8 @@ public:
   float   getCalibrateOffset();
   uint8_t getVersion();
   uint8_t getFirmware();
+  uint32_t getClock();
+  uint16_t getTransactionTime();
   void    setI2CAddress(uint8_t i2cAddress);
   bool    connected();
   void    writeEEPROM(uint8_t address,
@@ -95,6 +263,49 @@ public:
   void    setBlocking(bool);
   bool    getBlocking();
   void    readData();
+  uint8_t flush(uFire_EC_Writes &writes, uint16_t settle_ms=0);
+
+  template<class Reg>
+  typename Reg::type read()
+  {
+    static_assert(Reg::access & EC_ACCESS_READ, "register is write-only");
+    typename Reg::type v;
+    _read_bytes(Reg::offset, (uint8_t *)&v, Reg::size);
+    return v;
+  }
+
+  template<class Reg>
+  void write(typename Reg::type v)
+  {
+    static_assert(Reg::access & EC_ACCESS_WRITE, "register is read-only");
+    _write_bytes(Reg::offset, (const uint8_t *)&v, Reg::size);
+  }
+
+  template<class ... Regs>
+  void read(uFire_EC_Burst<Regs...> &burst)
+  {
+    static_assert(uFire_EC_Span<Regs...>::access & EC_ACCESS_READ, "burst includes a write-only register");
+    if (uFire_EC_Burst<Regs...>::single)
+    {
+      _read_bytes(burst.first, burst.data, burst.length);
+    }
+    else
+    {
+      int expand[] = { (_read_bytes(Regs::offset, &burst.data[Regs::offset - burst.first], Regs::size), 0)... };
+      (void)expand;
+    }
+  }
+
+  template<class ... Regs>
+  void write(const uFire_EC_Burst<Regs...> &burst)
+  {
+    static_assert(uFire_EC_Span<Regs...>::access & EC_ACCESS_WRITE, "burst includes a read-only register");
+    static_assert(uFire_EC_Burst<Regs...>::contiguous, "burst has gaps and cannot be written in one transaction");
+    static_assert(uFire_EC_Burst<Regs...>::length <= EC_WRITE_BURST_MAX, "burst is longer than EC_WRITE_BURST_MAX");
+    _write_bytes(burst.first, burst.data, burst.length);
+  }
+  static int32_t toFixed(uint32_t bits, uint16_t scale);
+  static uint32_t fromFixed(int32_t value, uint16_t scale);
 
 private:
 
@@ -102,17 +313,34 @@ private:
   TwoWire *_i2cPort;
   int16_t _ec_delay;
   bool    _blocking = true;
+  uFire_EC_Reading _reading;
+  uint8_t _pending = 0;
+  uFire_EC_Listener *_listeners = nullptr;
+  uint32_t _clock = 0;
+  uint16_t _transaction_us = 0;
+  uFire_EC *_clocked_next = nullptr;
+  static uFire_EC *_clocked;           /*!< instances that settled on a bus clock */
   float   _mS_to_mS25(float mS, float tempC);
   void    _updateRegisters();
+  void    _stage_temp(uFire_EC_Writes &writes, float temp_C);
+  void    _stage_temp_bits(uFire_EC_Writes &writes, uint32_t bits);
+  static int16_t _centi(uint32_t bits);
+  uint8_t _config(uint8_t bit, bool b);
+  void    _update_legacy();
   void    useTemperatureCompensation(bool b);
   void    _change_register(uint8_t register);
   void    _send_command(uint8_t command);
-  void    _write_register(uint8_t reg,
-                          float   f);
-  void    _write_byte(uint8_t reg,
-                      uint8_t val);
-  float   _read_register(uint8_t reg);
-  uint8_t _read_byte(uint8_t reg);
+  uint32_t _read_bits(uint8_t reg);
+  void    _read_bytes(uint8_t reg, uint8_t *data, uint8_t len);
+  void    _write_bytes(uint8_t reg, const uint8_t *data, uint8_t len);
+  uint32_t _negotiate_clock(uint32_t maxClock);
+  bool    _verify_clock(const uint8_t *expected);
+  bool    _readback(uint8_t *ids);
+  bool    _read_byte_checked(uint8_t *val);
+  void    _set_clock(uint32_t clock);
+  void    _unlink_clock();
 };
 
+} // inline namespace UFIRE_EC_CONFIG
+
 #endif // ifndef UFIRE_EC
\ No newline at end of file
@@ -1,16 +1,50 @@
 #ifdef __has_include
 #if __has_include("ArduinoJson.h")
 #include "uFire_EC_JSON.h"
+#include "uFire_EC_Trace.h"
 #include <ArduinoJson.h>
 
+#define EC_DOCUMENT_SIZE (JSON_OBJECT_SIZE(1) + 20)
+
 void uFire_EC_JSON::begin(uFire_EC *p_ec)
 {
   ec = p_ec;
   ec->begin();
 }
 
+void uFire_EC_JSON::setReport(uFire_EC_Report *p_report)
+{
+  report = p_report;
+}
+
 String uFire_EC_JSON::processJSON(String json)
 {
+  String output;
+  StaticJsonDocument<EC_DOCUMENT_SIZE> doc;
+
+  if (_process(json, doc)) serializeJson(doc, output);
+  return output;
+}
+
+size_t uFire_EC_JSON::processJSON(String json, Print &output)
+{
+  StaticJsonDocument<EC_DOCUMENT_SIZE> doc;
+
+  if (!_process(json, doc)) return 0;
+  return serializeJson(doc, output);
+}
+
+size_t uFire_EC_JSON::processJSON(String json, char *output, size_t size)
+{
+  StaticJsonDocument<EC_DOCUMENT_SIZE> doc;
+
+  if (!_process(json, doc)) return 0;
+  return serializeJson(doc, output, size);
+}
+
+bool uFire_EC_JSON::_process(String json, JsonDocument &doc)
+{
+  EC_TRACE_BEGIN(EC_TRACE_JSON, 0);
   String cmd = json.substring(0, json.indexOf(" ", 0));
   cmd.trim();
   json.remove(0, json.indexOf(" ", 0));
@@ -18,95 +52,68 @@ String uFire_EC_JSON::processJSON(String json)
   String parameter = json.substring(0, json.indexOf(" ", 0));
   parameter.trim();
 
-  String value = "";
-  if (cmd == "ec")            value = ec_measure(parameter);
-  if (cmd == "etc")           value = ec_temp_const(parameter);
-  if (cmd == "eco")           value = ec_temp_coeff(parameter);
-  if (cmd == "ehrf")          value = ec_high_ref(parameter);
-  if (cmd == "ehr")           value = ec_high_read();
-  if (cmd == "elrf")          value = ec_low_ref(parameter);
-  if (cmd == "elr")           value = ec_low_read();
-  if (cmd == "ecr")           value = ec_reset();
-  if (cmd == "ecc")           value = ec_connected();
-  if (cmd == "eo")            value = ec_offset(parameter);
-  if (cmd == "ect")           value = ec_temperature();
-
-  if (value != "")
-  {
-    this->value = value.toFloat();
-    return value;
-  } else
+  if (cmd == "ec")            ec_measure(doc, parameter);
+  if (cmd == "etc")           ec_temp_const(doc, parameter);
+  if (cmd == "eco")           ec_temp_coeff(doc, parameter);
+  if (cmd == "ehrf")          ec_high_ref(doc, parameter);
+  if (cmd == "ehr")           ec_high_read(doc);
+  if (cmd == "elrf")          ec_low_ref(doc, parameter);
+  if (cmd == "elr")           ec_low_read(doc);
+  if (cmd == "ecr")           ec_reset(doc);
+  if (cmd == "ecc")           ec_connected(doc);
+  if (cmd == "eo")            ec_offset(doc, parameter);
+  if (cmd == "ect")           ec_temperature(doc);
+  EC_TRACE_END(EC_TRACE_JSON, 0);
+
+  if (doc.isNull())
   {
     this->value = -1;
-    return "";
+    return false;
   }
+
+  JsonVariant result = doc.as<JsonObject>().begin()->value();
+  this->value = result.is<const char *>() ? -1 : result.as<float>();
+  return true;
 }
 
-String uFire_EC_JSON::ec_reset()
+void uFire_EC_JSON::ec_reset(JsonDocument &doc)
 {
-  String output;
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   doc["ecr"] = "ecr";
   ec->reset();
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_connected()
+void uFire_EC_JSON::ec_connected(JsonDocument &doc)
 {
-  String output;
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   doc["ecc"] = ec->connected();
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_temp_const(String parameter)
+void uFire_EC_JSON::ec_temp_const(JsonDocument &doc, String parameter)
 {
-  String output;
-
   if (parameter.length())
   {
     ec->setTempConstant(parameter.toFloat());
   }
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   doc["etc"] = ec->getTempConstant();
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_temp_coeff(String parameter)
+void uFire_EC_JSON::ec_temp_coeff(JsonDocument &doc, String parameter)
 {
-  String output;
-
   if (parameter.length())
   {
     ec->setTempCoefficient(parameter.toFloat());
   }
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   doc["eco"] = ec->getTempCoefficient();
-  serializeJson(doc, output);
-  return output;
-
 }
 
-String uFire_EC_JSON::ec_high_ref(String parameter)
+void uFire_EC_JSON::ec_high_ref(JsonDocument &doc, String parameter)
 {
-  String output;
-
   if (parameter.length())
   {
     ec->calibrateProbeHigh(parameter.toFloat());
   }
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   float highReference = ec->getCalibrateHighReference();
   if (isnan(highReference)) {
     doc["ehrf"]  = "-";
@@ -114,16 +121,10 @@ String uFire_EC_JSON::ec_high_ref(String parameter)
   else {
     doc["ehrf"] = highReference;
   }
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_high_read()
+void uFire_EC_JSON::ec_high_read(JsonDocument &doc)
 {
-  String output;
-
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   float highRead = ec->getCalibrateHighReading();
   if (isnan(highRead)) {
     doc["ehr"]  = "-";
@@ -131,21 +132,15 @@ String uFire_EC_JSON::ec_high_read()
   else {
     doc["ehr"] = highRead;
   }
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_low_ref(String parameter)
+void uFire_EC_JSON::ec_low_ref(JsonDocument &doc, String parameter)
 {
-  String output;
-
   if (parameter.length())
   {
     ec->calibrateProbeLow(parameter.toFloat());
   }
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   float lowRef = ec->getCalibrateLowReference();
   if (isnan(lowRef)) {
     doc["elrf"]  = "-";
@@ -153,16 +148,10 @@ String uFire_EC_JSON::ec_low_ref(String parameter)
   else {
     doc["elrf"] = lowRef;
   }
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_low_read()
+void uFire_EC_JSON::ec_low_read(JsonDocument &doc)
 {
-  String output;
-
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   float lowRead = ec->getCalibrateLowReading();
   if (isnan(lowRead)) {
     doc["elr"]  = "-";
@@ -170,32 +159,26 @@ String uFire_EC_JSON::ec_low_read()
   else {
     doc["elr"] = lowRead;
   }
-  serializeJson(doc, output);
-  return output;
 }
 
-String uFire_EC_JSON::ec_measure(String temperature)
+void uFire_EC_JSON::ec_measure(JsonDocument &doc, String temperature)
 {
-  String output;
+  // drop a change left by readings taken elsewhere, so only this one counts
+  if (report) report->changed();
+  float mS = ec->measureEC(temperature.toFloat());
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
-  doc["ec"] = floor(ec->measureEC(temperature.toFloat()) * 100.0 + 0.5) / 100.0;
-  serializeJson(doc, output);
-  return output;
+  // with a report filter attached, only meaningful changes produce output
+  if (report && !report->changed()) return;
+  doc["ec"] = floor(mS * 100.0 + 0.5) / 100.0;
 }
 
-String uFire_EC_JSON::ec_offset(String parameter)
+void uFire_EC_JSON::ec_offset(JsonDocument &doc, String parameter)
 {
-  String output;
-
   if (parameter.length())
   {
     ec->calibrateProbe(parameter.toFloat());
   }
 
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
   float offset = ec->getCalibrateOffset();
   if (isnan(offset)) {
     doc["eo"]  = "-";
@@ -203,19 +186,15 @@ String uFire_EC_JSON::ec_offset(String parameter)
   else {
     doc["eo"] = offset;
   }
-  serializeJson(doc, output);
-
-  return output;
 }
 
-String uFire_EC_JSON::ec_temperature()
+void uFire_EC_JSON::ec_temperature(JsonDocument &doc)
 {
-  String output;
-  const size_t bufferSize = JSON_OBJECT_SIZE(1) + 20;
-  DynamicJsonDocument doc(bufferSize);
-  doc["ect"] = floor(ec->measureTemp() * 100.0 + 0.5) / 100.0;
-  serializeJson(doc, output);
-  return output;
+  if (report) report->changed();
+  float tempC = ec->measureTemp();
+
+  if (report && !report->changed()) return;
+  doc["ect"] = floor(tempC * 100.0 + 0.5) / 100.0;
 }
 #endif
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <uFire_EC.h>
+#include <uFire_EC_Report.h>
+#include <ArduinoJson.h>
 
 class uFire_EC_MP
 {
@@ -8,18 +10,26 @@ public:
   float value;
   uFire_EC_MP(){}
   void begin(uFire_EC *ec);
+  // with a report attached, "ec" and "ect" answer only when their own reading
+  // passes its filter; a suppressed command returns like an unknown one: an
+  // empty String or 0 bytes, and value == -1
+  void setReport(uFire_EC_Report *report);
   String processMP(String json);
+  size_t processMP(String json, Print &output);
+  size_t processMP(String json, char *output, size_t size);
 private:
   uFire_EC *ec;
-  String ec_reset();
-  String ec_connected();
-  String ec_temp_const(String);
-  String ec_temp_coeff(String);
-  String ec_high_ref(String);
-  String ec_high_read();
-  String ec_low_ref(String);
-  String ec_low_read();
-  String ec_measure(String);
-  String ec_offset(String);
-  String ec_temperature();
+  uFire_EC_Report *report = nullptr;
+  bool _process(String json, JsonDocument &doc);
+  void ec_reset(JsonDocument &);
+  void ec_connected(JsonDocument &);
+  void ec_temp_const(JsonDocument &, String);
+  void ec_temp_coeff(JsonDocument &, String);
+  void ec_high_ref(JsonDocument &, String);
+  void ec_high_read(JsonDocument &);
+  void ec_low_ref(JsonDocument &, String);
+  void ec_low_read(JsonDocument &);
+  void ec_measure(JsonDocument &, String);
+  void ec_offset(JsonDocument &, String);
+  void ec_temperature(JsonDocument &);
 };
@@ -0,0 +1,93 @@
+#pragma once
+
+// Typed descriptors for the register map in uFire_EC.h. The offsets stay
+// defined there; these add the width and direction of each register so
+// uFire_EC::read<>() and write<>() can size every transfer at compile time.
+
+#define EC_ACCESS_READ 1                  /*!< register can be read */
+#define EC_ACCESS_WRITE 2                 /*!< register can be written */
+#define EC_ACCESS_RW (EC_ACCESS_READ | EC_ACCESS_WRITE)
+
+template<uint8_t Offset, typename T, uint8_t Access>
+struct uFire_EC_Register                  /*! One register: offset, value type and access */
+{
+  typedef T type;
+  static constexpr uint8_t offset = Offset;
+  static constexpr uint8_t size   = sizeof(T);
+  static constexpr uint8_t access = Access;
+};
+
+typedef uFire_EC_Register<EC_VERSION_REGISTER, uint8_t, EC_ACCESS_READ>          EC_Reg_Version;
+typedef uFire_EC_Register<EC_MS_REGISTER, float, EC_ACCESS_READ>                 EC_Reg_MS;
+typedef uFire_EC_Register<EC_TEMP_REGISTER, float, EC_ACCESS_RW>                 EC_Reg_Temp;
+typedef uFire_EC_Register<EC_SOLUTION_REGISTER, float, EC_ACCESS_RW>             EC_Reg_Solution;
+typedef uFire_EC_Register<EC_TEMPCOEF_REGISTER, float, EC_ACCESS_RW>             EC_Reg_TempCoef;
+typedef uFire_EC_Register<EC_CALIBRATE_REFHIGH_REGISTER, float, EC_ACCESS_RW>    EC_Reg_CalibrateRefHigh;
+typedef uFire_EC_Register<EC_CALIBRATE_REFLOW_REGISTER, float, EC_ACCESS_RW>     EC_Reg_CalibrateRefLow;
+typedef uFire_EC_Register<EC_CALIBRATE_READHIGH_REGISTER, float, EC_ACCESS_RW>   EC_Reg_CalibrateReadHigh;
+typedef uFire_EC_Register<EC_CALIBRATE_READLOW_REGISTER, float, EC_ACCESS_RW>    EC_Reg_CalibrateReadLow;
+typedef uFire_EC_Register<EC_CALIBRATE_OFFSET_REGISTER, float, EC_ACCESS_RW>     EC_Reg_CalibrateOffset;
+typedef uFire_EC_Register<EC_SALINITY_PSU, float, EC_ACCESS_READ>                EC_Reg_Salinity;
+typedef uFire_EC_Register<EC_RAW_REGISTER, float, EC_ACCESS_READ>                EC_Reg_Raw;
+typedef uFire_EC_Register<EC_TEMP_COMPENSATION_REGISTER, float, EC_ACCESS_RW>    EC_Reg_TempCompensation;
+typedef uFire_EC_Register<EC_BUFFER_REGISTER, float, EC_ACCESS_RW>               EC_Reg_Buffer;
+typedef uFire_EC_Register<EC_FW_VERSION_REGISTER, uint8_t, EC_ACCESS_READ>       EC_Reg_Firmware;
+typedef uFire_EC_Register<EC_CONFIG_REGISTER, uint8_t, EC_ACCESS_RW>             EC_Reg_Config;
+typedef uFire_EC_Register<EC_TASK_REGISTER, uint8_t, EC_ACCESS_WRITE>            EC_Reg_Task;
+
+template<class ... Regs>
+struct uFire_EC_Span;
+
+template<class Reg>
+struct uFire_EC_Span<Reg>
+{
+  static constexpr uint8_t first    = Reg::offset;
+  static constexpr uint8_t end      = Reg::offset + Reg::size;
+  static constexpr uint8_t bytes    = Reg::size;
+  static constexpr uint8_t access   = Reg::access;
+  static constexpr uint8_t count    = 1;
+};
+
+template<class Reg, class ... Rest>
+struct uFire_EC_Span<Reg, Rest...>
+{
+  static constexpr uint8_t first    = Reg::offset < uFire_EC_Span<Rest...>::first ? Reg::offset : uFire_EC_Span<Rest...>::first;
+  static constexpr uint8_t end      = Reg::offset + Reg::size > uFire_EC_Span<Rest...>::end ? Reg::offset + Reg::size : uFire_EC_Span<Rest...>::end;
+  static constexpr uint8_t bytes    = Reg::size + uFire_EC_Span<Rest...>::bytes;
+  static constexpr uint8_t access   = Reg::access & uFire_EC_Span<Rest...>::access;
+  static constexpr uint8_t count    = 1 + uFire_EC_Span<Rest...>::count;
+};
+
+template<class ... Regs>
+struct uFire_EC_Burst                     /*! Buffer covering the smallest register range that holds Regs */
+{
+  typedef uFire_EC_Span<Regs...> span;
+
+  static constexpr uint8_t first  = span::first;
+  static constexpr uint8_t length = span::end - span::first;
+
+  // a read is one pointer write plus one request per byte, so reading the
+  // whole range wins when the gaps cost less than the pointer writes saved
+  static constexpr bool    single = length + 1 <= span::bytes + span::count;
+
+  // writes can only cover the range in one go when there are no gaps
+  static constexpr bool    contiguous = length == span::bytes;
+
+  uint8_t data[length];
+
+  template<class Reg>
+  typename Reg::type get() const
+  {
+    static_assert(Reg::offset >= first && Reg::offset + Reg::size <= first + length, "register outside burst");
+    typename Reg::type v;
+    memcpy(&v, &data[Reg::offset - first], Reg::size);
+    return v;
+  }
+
+  template<class Reg>
+  void set(typename Reg::type v)
+  {
+    static_assert(Reg::offset >= first && Reg::offset + Reg::size <= first + length, "register outside burst");
+    memcpy(&data[Reg::offset - first], &v, Reg::size);
+  }
+};
@@ -0,0 +1,132 @@
+#include "uFire_EC_Report.h"
+
+void uFire_EC_Report::begin(uFire_EC *ec, uint32_t heartbeat_ms)
+{
+  _ec          = ec;
+  _heartbeat   = heartbeat_ms;
+  _suppressed  = 0;
+  _last_report = millis();
+  _first       = true;
+  _pending     = false;
+  for (uint8_t i = 0; i < EC_REPORT_QUANTITIES; i++)
+  {
+    _q[i].absolute   = 0;
+    _q[i].relative   = 0;
+    _q[i].low        = NAN;
+    _q[i].high       = NAN;
+    _q[i].hysteresis = 0;
+    _q[i].reported   = NAN;
+    _q[i].state      = EC_ALERT_NORMAL;
+  }
+  _ec->addListener(this);
+}
+
+void uFire_EC_Report::end()
+{
+  if (_ec) _ec->removeListener(this);
+  _ec = nullptr;
+}
+
+void uFire_EC_Report::setDeadband(uint8_t quantity, float absolute, float relative)
+{
+  if (quantity >= EC_REPORT_QUANTITIES) return;
+
+  _q[quantity].absolute = absolute;
+  _q[quantity].relative = relative;
+}
+
+void uFire_EC_Report::setAlarm(uint8_t quantity, float low, float high, float hysteresis)
+{
+  if (quantity >= EC_REPORT_QUANTITIES) return;
+
+  _q[quantity].low        = low;
+  _q[quantity].high       = high;
+  _q[quantity].hysteresis = hysteresis;
+}
+
+void uFire_EC_Report::onAlert(uFire_EC_AlertCallback callback)
+{
+  _callback = callback;
+}
+
+void uFire_EC_Report::setHeartbeat(uint32_t heartbeat_ms)
+{
+  _heartbeat = heartbeat_ms;
+}
+
+bool uFire_EC_Report::changed()
+{
+  bool retval = _pending;
+
+  _pending = false;
+  return retval;
+}
+
+uint8_t uFire_EC_Report::getState(uint8_t quantity)
+{
+  return quantity < EC_REPORT_QUANTITIES ? _q[quantity].state : EC_ALERT_NORMAL;
+}
+
+float uFire_EC_Report::getReported(uint8_t quantity)
+{
+  return quantity < EC_REPORT_QUANTITIES ? _q[quantity].reported : NAN;
+}
+
+uint32_t uFire_EC_Report::getSuppressed()
+{
+  return _suppressed;
+}
+
+void uFire_EC_Report::onReading(uFire_EC &ec, const uFire_EC_Reading &reading)
+{
+  (void)ec;
+  float    values[EC_REPORT_QUANTITIES] = { reading.mS(), reading.tempC(), reading.salinityPSU() };
+  uint32_t now                          = millis();
+  bool     report                       = _first;
+
+  if (_heartbeat && (now - _last_report >= _heartbeat)) report = true;
+
+  for (uint8_t i = 0; i < EC_REPORT_QUANTITIES; i++)
+  {
+    // every alarm transition is reported, so evaluate all of them
+    if (_alarm(i, values[i])) report = true;
+
+    // a change has to clear both deadbands, measured from the last value sent so
+    // slow creep still gets through
+    float delta = fabs(values[i] - _q[i].reported);
+    if ((delta > _q[i].absolute) && (delta > _q[i].relative * fabs(_q[i].reported))) report = true;
+    if (isnan(_q[i].reported)) report = true;
+  }
+
+  if (!report)
+  {
+    _suppressed++;
+    return;
+  }
+
+  for (uint8_t i = 0; i < EC_REPORT_QUANTITIES; i++)
+  {
+    _q[i].reported = values[i];
+  }
+  _last_report = now;
+  _first       = false;
+  _pending     = true;
+}
+
+bool uFire_EC_Report::_alarm(uint8_t quantity, float value)
+{
+  uint8_t state = _q[quantity].state;
+  float   hyst  = _q[quantity].hysteresis;
+
+  // leave an alarm only once the value is back past the threshold by the hysteresis
+  if (state == EC_ALERT_HIGH && value < _q[quantity].high - hyst) state = EC_ALERT_NORMAL;
+  if (state == EC_ALERT_LOW && value > _q[quantity].low + hyst) state = EC_ALERT_NORMAL;
+  if (value > _q[quantity].high) state = EC_ALERT_HIGH;
+  if (value < _q[quantity].low) state = EC_ALERT_LOW;
+
+  if (state == _q[quantity].state) return false;
+
+  _q[quantity].state = state;
+  if (_callback) _callback(quantity, state, value);
+  return true;
+}
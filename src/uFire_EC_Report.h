@@ -0,0 +1,51 @@
+#pragma once
+
+#include <uFire_EC.h>
+
+#define EC_REPORT_EC 0              /*!< EC in mS */
+#define EC_REPORT_TEMP 1            /*!< temperature in C */
+#define EC_REPORT_SALINITY 2        /*!< salinity in PSU */
+#define EC_REPORT_QUANTITIES 3
+
+#define EC_ALERT_NORMAL 0           /*!< back inside the alarm band */
+#define EC_ALERT_LOW 1              /*!< fell below the low threshold */
+#define EC_ALERT_HIGH 2             /*!< rose above the high threshold */
+
+typedef void (*uFire_EC_AlertCallback)(uint8_t quantity, uint8_t state, float value);
+
+class uFire_EC_Report : public uFire_EC_Listener /*! Report-by-exception filter for uFire_EC readings */
+{
+public:
+  uFire_EC_Report(){}
+  void  begin(uFire_EC *ec, uint32_t heartbeat_ms=0);
+  void  end();
+  void  setDeadband(uint8_t quantity, float absolute, float relative=0);
+  void  setAlarm(uint8_t quantity, float low, float high, float hysteresis=0);
+  void  onAlert(uFire_EC_AlertCallback callback);
+  void  setHeartbeat(uint32_t heartbeat_ms);
+  bool  changed();
+  uint8_t getState(uint8_t quantity);
+  float getReported(uint8_t quantity);
+  uint32_t getSuppressed();
+  void  onReading(uFire_EC &ec, const uFire_EC_Reading &reading);
+
+private:
+  struct
+  {
+    float   absolute;
+    float   relative;
+    float   low;
+    float   high;
+    float   hysteresis;
+    float   reported;
+    uint8_t state;
+  }        _q[EC_REPORT_QUANTITIES];
+  uFire_EC *_ec = nullptr;
+  uFire_EC_AlertCallback _callback = nullptr;
+  uint32_t _heartbeat;
+  uint32_t _last_report;
+  uint32_t _suppressed;
+  bool     _first;
+  bool     _pending;
+  bool     _alarm(uint8_t quantity, float value);
+};
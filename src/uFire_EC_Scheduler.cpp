@@ -0,0 +1,184 @@
+#include "uFire_EC_Scheduler.h"
+#include "uFire_EC_Trace.h"
+
+void uFire_EC_Scheduler::begin(uint32_t period_ms, float temp, float temp_constant)
+{
+  _period        = period_ms;
+  _temp          = temp;
+  _temp_constant = temp_constant;
+  _converting    = false;
+  _setup_ms      = 0;
+  _jitter_bin    = period_ms / 64 ? period_ms / 64 : 1;
+  resetStats();
+  _plan_first();
+}
+
+bool uFire_EC_Scheduler::add(uFire_EC *ec)
+{
+  if (_count >= EC_SCHEDULER_MAX_PROBES) return false;
+
+  _probes[_count++] = ec;
+
+  // a slower probe lengthens the conversion, so re-plan a first cycle that has not started
+  if (_period && !cycles && !_converting) _plan_first();
+  return true;
+}
+
+bool uFire_EC_Scheduler::update()
+{
+  uint32_t now = millis();
+
+  if (_converting)
+  {
+    if ((int32_t)(now - _ready_at) < 0) return false;
+
+    _finish(now);
+    return true;
+  }
+
+  // not started, or started without a period
+  if (!_period) return false;
+
+  // trigger early by the measured cycle cost so the reading lands on the deadline
+  uint32_t trigger = _deadline - _lead;
+  if ((int32_t)(now - trigger) < 0) return false;
+
+  // skip to the next trigger still ahead rather than starting off-phase
+  uint32_t late = now - trigger;
+  if (late >= _period)
+  {
+    uint32_t skipped = late / _period + 1;
+    _deadline += skipped * _period;
+    overruns  += skipped;
+    if (overrunHistogram[_bin(skipped)] < 0xFFFF) overrunHistogram[_bin(skipped)]++;
+    return false;
+  }
+
+  _start(now);
+  return false;
+}
+
+void uFire_EC_Scheduler::setTemp(float temp_C)
+{
+  _temp = temp_C;
+}
+
+void uFire_EC_Scheduler::resetStats()
+{
+  cycles   = 0;
+  overruns = 0;
+  _jitter  = 0;
+  for (uint8_t i = 0; i < EC_SCHEDULER_BINS; i++)
+  {
+    jitterHistogram[i]  = 0;
+    overrunHistogram[i] = 0;
+  }
+}
+
+uint32_t uFire_EC_Scheduler::getPeriod()
+{
+  return _period;
+}
+
+uint32_t uFire_EC_Scheduler::getDeadline()
+{
+  return _deadline;
+}
+
+uint32_t uFire_EC_Scheduler::getLead()
+{
+  return _lead;
+}
+
+int32_t uFire_EC_Scheduler::getLastJitter()
+{
+  return _jitter;
+}
+
+void uFire_EC_Scheduler::setJitterBin(uint16_t ms)
+{
+  _jitter_bin = ms ? ms : 1;
+}
+
+uint16_t uFire_EC_Scheduler::getJitterBin()
+{
+  return _jitter_bin;
+}
+
+void uFire_EC_Scheduler::_plan_first()
+{
+  _lead = _conversion_time();
+  if (_lead > _period) _lead = _period;
+
+  // first deadline is as soon as one conversion can complete
+  _deadline = millis() + _lead;
+}
+
+void uFire_EC_Scheduler::_start(uint32_t now)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _probes[i]->startEC(_temp, _temp_constant);
+  }
+
+  // all probes convert in parallel, so one conversion time covers the sweep
+  _setup_ms   = millis() - now;
+  _ready_at   = now + _setup_ms + _conversion_time();
+  _converting = true;
+  EC_TRACE_BEGIN(EC_TRACE_CONVERSION, 0);
+}
+
+void uFire_EC_Scheduler::_finish(uint32_t now)
+{
+  EC_TRACE_END(EC_TRACE_CONVERSION, 0);
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _probes[i]->readMeasurement();
+  }
+
+  uint32_t done = millis();
+  _jitter = (int32_t)(done - _deadline);
+  if (jitterHistogram[_jitter_index(_jitter)] < 0xFFFF) jitterHistogram[_jitter_index(_jitter)]++;
+
+  // smooth the lead so a single slow bus transaction does not shift the phase
+  uint32_t cost = _setup_ms + _conversion_time() + (done - now);
+  _lead = (_lead * 3 + cost) / 4;
+  if (_lead > _period) _lead = _period;
+
+  _deadline  += _period;
+  _converting = false;
+  cycles++;
+}
+
+uint32_t uFire_EC_Scheduler::_conversion_time()
+{
+  int16_t longest = EC_EC_MEASUREMENT_TIME;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_probes[i]->getMeasureTime() > longest) longest = _probes[i]->getMeasureTime();
+  }
+  return longest;
+}
+
+uint8_t uFire_EC_Scheduler::_jitter_index(int32_t v)
+{
+  // early completions fill the lower half, late ones the upper half
+  int32_t i = (v >= 0 ? v / _jitter_bin : (v + 1) / _jitter_bin - 1) + EC_SCHEDULER_BINS / 2;
+
+  if (i < 0) return 0;
+  if (i > EC_SCHEDULER_BINS - 1) return EC_SCHEDULER_BINS - 1;
+  return i;
+}
+
+uint8_t uFire_EC_Scheduler::_bin(uint32_t v)
+{
+  uint8_t b = 0;
+
+  while (v && b < EC_SCHEDULER_BINS - 1)
+  {
+    v >>= 1;
+    b++;
+  }
+  return b;
+}
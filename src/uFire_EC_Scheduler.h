@@ -0,0 +1,52 @@
+#pragma once
+
+#include <uFire_EC.h>
+
+#ifndef EC_SCHEDULER_MAX_PROBES
+# define EC_SCHEDULER_MAX_PROBES 4 /*!< probes swept by one scheduler */
+#endif // ifndef EC_SCHEDULER_MAX_PROBES
+#ifndef EC_SCHEDULER_BINS
+# define EC_SCHEDULER_BINS 8      /*!< histogram bins */
+#endif // ifndef EC_SCHEDULER_BINS
+
+class uFire_EC_Scheduler /*! Fixed-period measurement scheduler with absolute deadlines */
+{
+public:
+  uint32_t cycles;                              /*!< completed measurement cycles */
+  uint32_t overruns;                            /*!< periods skipped because a cycle ran late */
+  uint16_t jitterHistogram[EC_SCHEDULER_BINS];  /*!< completion minus deadline, getJitterBin() ms per bin, centred on 0, end bins open */
+  uint16_t overrunHistogram[EC_SCHEDULER_BINS]; /*!< periods skipped per overrun event, log2 binned */
+
+  uFire_EC_Scheduler(){}
+  void     begin(uint32_t period_ms, float temp=25.0, float temp_constant=25.0);
+  bool     add(uFire_EC *ec);
+  bool     update();
+  void     setTemp(float temp_C);
+  void     resetStats();
+  uint32_t getPeriod();
+  uint32_t getDeadline();
+  uint32_t getLead();
+  int32_t  getLastJitter();
+  void     setJitterBin(uint16_t ms);
+  uint16_t getJitterBin();
+
+private:
+  uFire_EC *_probes[EC_SCHEDULER_MAX_PROBES];
+  uint8_t   _count = 0;
+  bool      _converting = false;
+  uint32_t  _period = 0;
+  uint32_t  _deadline = 0;
+  uint32_t  _lead = 0;
+  uint32_t  _ready_at;
+  uint32_t  _setup_ms;
+  int32_t   _jitter;
+  uint16_t  _jitter_bin;
+  float     _temp;
+  float     _temp_constant;
+  void      _plan_first();
+  void      _start(uint32_t now);
+  void      _finish(uint32_t now);
+  uint32_t  _conversion_time();
+  uint8_t   _jitter_index(int32_t v);
+  static uint8_t _bin(uint32_t v);
+};
@@ -0,0 +1,74 @@
+#include "uFire_EC_Snapshot.h"
+
+// One task samples, any number read. Publication n goes to slot n & 1 while
+// readers copy the other slot, so the writer never waits. A reader only
+// retries if a whole new reading was published during its copy.
+
+#if defined(__AVR__)
+# define EC_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#endif // if defined(__AVR__)
+
+void uFire_EC_Snapshot::begin(uFire_EC *ec)
+{
+  _ec  = ec;
+  _seq = 0;
+  _ec->addListener(this);
+}
+
+void uFire_EC_Snapshot::end()
+{
+  if (_ec) _ec->removeListener(this);
+  _ec = nullptr;
+}
+
+uint32_t uFire_EC_Snapshot::read(uFire_EC_Reading &reading)
+{
+#if defined(__AVR__)
+  for (;;)
+  {
+    uint8_t before = _seq;
+    EC_BARRIER();
+    reading = _slots[before & 1];
+    EC_BARRIER();
+    if (_seq == before) return before;
+  }
+#else // if defined(__AVR__)
+  for (;;)
+  {
+    uint32_t before = _seq.load(std::memory_order_acquire);
+    reading = _slots[before & 1];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_seq.load(std::memory_order_relaxed) == before) return before;
+  }
+#endif // if defined(__AVR__)
+}
+
+uint32_t uFire_EC_Snapshot::sequence()
+{
+#if defined(__AVR__)
+  return _seq;
+#else // if defined(__AVR__)
+  return _seq.load(std::memory_order_acquire);
+#endif // if defined(__AVR__)
+}
+
+void uFire_EC_Snapshot::onReading(uFire_EC &ec, const uFire_EC_Reading &reading)
+{
+  (void)ec;
+#if defined(__AVR__)
+  uint8_t next = _seq + 1;
+  if (next == 0) next = 2;
+  EC_BARRIER();
+  _slots[next & 1] = reading;
+  EC_BARRIER();
+  _seq = next;
+#else // if defined(__AVR__)
+  uint32_t next = _seq.load(std::memory_order_relaxed) + 1;
+  if (next == 0) next = 2;
+
+  // the previous publication must be visible before its old slot is reused
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  _slots[next & 1] = reading;
+  _seq.store(next, std::memory_order_release);
+#endif // if defined(__AVR__)
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <uFire_EC.h>
+
+#if !defined(__AVR__)
+# include <atomic>
+#endif // if !defined(__AVR__)
+
+class uFire_EC_Snapshot : public uFire_EC_Listener /*! Publishes complete readings to other tasks without locks */
+{
+public:
+  uFire_EC_Snapshot(){}
+  void     begin(uFire_EC *ec);
+  void     end();
+  uint32_t read(uFire_EC_Reading &reading);
+  uint32_t sequence();
+  void     onReading(uFire_EC &ec, const uFire_EC_Reading &reading);
+
+private:
+  uFire_EC        *_ec = nullptr;
+  uFire_EC_Reading _slots[2];
+#if defined(__AVR__)
+  volatile uint8_t _seq = 0;
+#else // if defined(__AVR__)
+  std::atomic<uint32_t> _seq;
+#endif // if defined(__AVR__)
+};
@@ -0,0 +1,131 @@
+#include "uFire_EC_Stats.h"
+
+void uFire_EC_Stats::begin(uFire_EC *ec, uint16_t window)
+{
+  _ec        = ec;
+  _window    = window ? window : 1;
+  _available = false;
+  _baseline  = NAN;
+  _falling   = 0;
+  _summary   = uFire_EC_Summary();
+  refreshCalibration();
+  _reset_window();
+  _ec->addListener(this);
+}
+
+void uFire_EC_Stats::end()
+{
+  if (_ec) _ec->removeListener(this);
+  _ec = nullptr;
+}
+
+void uFire_EC_Stats::refreshCalibration()
+{
+  // after a dual-point calibration the device maps its readings onto the
+  // reference solutions, so calibrated mS is compared with the references
+  _ref_low  = _ec->getCalibrateLowReference();
+  _ref_high = _ec->getCalibrateHighReference();
+}
+
+bool uFire_EC_Stats::available()
+{
+  return _available;
+}
+
+const uFire_EC_Summary &uFire_EC_Stats::summary()
+{
+  _available = false;
+  return _summary;
+}
+
+void uFire_EC_Stats::onReading(uFire_EC &ec, const uFire_EC_Reading &reading)
+{
+  (void)ec;
+
+  // temperature measurements and plain re-reads carry a stale EC value
+  if (reading.measured() != EC_MEASURE_EC) return;
+  if (!reading.hasEC())
+  {
+    _current.invalid++;
+    return;
+  }
+
+  float x = reading.mS();
+
+  uint32_t now = millis();
+  if (_current.count == 0) _start = now;
+
+  // Welford updates for the mean and variance of mS and its covariance with time
+  float    t  = (now - _start) / 3600000.0;
+  uint16_t n  = ++_current.count;
+  float    dt = t - _mean_t;
+  float    dx = x - _current.mean;
+  _mean_t       += dt / n;
+  _current.mean += dx / n;
+  _m2_t         += dt * (t - _mean_t);
+  _m2_x         += dx * (x - _current.mean);
+  _c_tx         += dt * (x - _current.mean);
+
+  if (n == 1 || x < _current.min) _current.min = x;
+  if (n == 1 || x > _current.max) _current.max = x;
+
+  if (n >= _window) _close_window();
+}
+
+void uFire_EC_Stats::_reset_window()
+{
+  _current = uFire_EC_Summary();
+  _mean_t  = 0;
+  _m2_t    = 0;
+  _c_tx    = 0;
+  _m2_x    = 0;
+}
+
+void uFire_EC_Stats::_close_window()
+{
+  uint16_t n = _current.count;
+
+  _current.variance = n > 1 ? _m2_x / (n - 1) : 0;
+  _current.slope    = _m2_t > 0 ? _c_tx / _m2_t : 0;
+  if (isnan(_baseline)) _baseline = _current.mean;
+  _current.drift = _check_drift();
+
+  _summary   = _current;
+  _available = true;
+  _reset_window();
+}
+
+uint8_t uFire_EC_Stats::_check_drift()
+{
+  uint8_t  flags = 0;
+  bool     dual  = !isnan(_ref_low) && !isnan(_ref_high) && _ref_low != _ref_high;
+  float    span  = dual ? fabs(_ref_high - _ref_low) : _baseline;
+  float    slope = _current.slope;
+  uint16_t n     = _current.count;
+
+  if (span > 0 && fabs(slope) > driftRate * span) flags |= EC_DRIFT_TREND;
+
+  // a fall is significant when the slope is more than twice its standard error
+  bool falling = false;
+  if (n > 2 && _m2_t > 0 && slope < 0)
+  {
+    float residual = _m2_x - (_c_tx * _c_tx) / _m2_t;
+    if (residual < 0) residual = 0;
+    float se = sqrt(residual / (n - 2) / _m2_t);
+    falling = -slope > 2 * se;
+  }
+  _falling = falling ? (_falling < 0xFF ? _falling + 1 : _falling) : 0;
+  if (foulingCount && _falling >= foulingCount) flags |= EC_DRIFT_FOULING;
+
+  if (dual)
+  {
+    float low  = _ref_low < _ref_high ? _ref_low : _ref_high;
+    float high = _ref_low < _ref_high ? _ref_high : _ref_low;
+    if ((_current.mean < low - rangeMargin * span) || (_current.mean > high + rangeMargin * span))
+    {
+      flags |= EC_DRIFT_RANGE;
+    }
+  }
+
+  return flags;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <uFire_EC.h>
+
+#define EC_STATS_WINDOW 60          /*!< default readings per window */
+
+#define EC_DRIFT_TREND 1            /*!< window slope exceeds the drift rate */
+#define EC_DRIFT_FOULING 2          /*!< sustained downward trend, typical of a fouled probe */
+#define EC_DRIFT_RANGE 4            /*!< window mean outside the calibrated span */
+
+struct uFire_EC_Summary             /*! Statistics of one window of EC readings */
+{
+  uint16_t count;                   /*!< valid readings in the window */
+  uint16_t invalid;                 /*!< readings skipped because the probe reported no EC */
+  float    mean;                    /*!< mean mS */
+  float    variance;                /*!< sample variance of mS */
+  float    min;                     /*!< smallest mS */
+  float    max;                     /*!< largest mS */
+  float    slope;                   /*!< least-squares trend in mS per hour */
+  uint8_t  drift;                   /*!< EC_DRIFT_* flags */
+};
+
+class uFire_EC_Stats : public uFire_EC_Listener /*! Windowed EC statistics and drift detection in constant memory */
+{
+public:
+  float   driftRate    = 0.02;      /*!< allowed trend, fraction of the calibrated span per hour */
+  float   rangeMargin  = 0.1;       /*!< allowed excursion outside the calibrated span, fraction of the span */
+  uint8_t foulingCount = 3;         /*!< consecutive falling windows that flag fouling */
+
+  uFire_EC_Stats(){}
+  void  begin(uFire_EC *ec, uint16_t window=EC_STATS_WINDOW);
+  void  end();
+  void  refreshCalibration();
+  bool  available();
+  const uFire_EC_Summary &summary();
+  void  onReading(uFire_EC &ec, const uFire_EC_Reading &reading);
+
+private:
+  uFire_EC        *_ec = nullptr;
+  uint16_t         _window;
+  bool             _available = false;
+  uFire_EC_Summary _summary;
+  uFire_EC_Summary _current;
+  uint32_t         _start;
+  float            _mean_t;
+  float            _m2_t;
+  float            _c_tx;
+  float            _m2_x;
+  float            _ref_low;
+  float            _ref_high;
+  float            _baseline;
+  uint8_t          _falling;
+  void             _reset_window();
+  void             _close_window();
+  uint8_t          _check_drift();
+};
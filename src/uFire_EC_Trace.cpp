@@ -0,0 +1,60 @@
+#include "uFire_EC_Trace.h"
+
+#if defined(UFIRE_EC_TRACE)
+uFire_EC_TraceEvent uFire_EC_Trace::_events[EC_TRACE_EVENTS];
+uint16_t uFire_EC_Trace::_head    = 0;
+uint16_t uFire_EC_Trace::_count   = 0;
+uint32_t uFire_EC_Trace::_dropped = 0;
+
+void uFire_EC_Trace::record(uint8_t phase, uint8_t address, bool begin)
+{
+  uFire_EC_TraceEvent &e = _events[_head];
+
+  e.micros  = micros();
+  e.phase   = phase;
+  e.address = address;
+  e.begin   = begin;
+
+  // overwrite the oldest event once the buffer is full
+  _head = (_head + 1) % EC_TRACE_EVENTS;
+  if (_count < EC_TRACE_EVENTS) _count++;
+  else _dropped++;
+}
+
+uint16_t uFire_EC_Trace::count()
+{
+  return _count;
+}
+
+uint32_t uFire_EC_Trace::dropped()
+{
+  return _dropped;
+}
+
+void uFire_EC_Trace::clear()
+{
+  _head    = 0;
+  _count   = 0;
+  _dropped = 0;
+}
+
+void uFire_EC_Trace::dump(Print &out)
+{
+  uint16_t first = (_head + EC_TRACE_EVENTS - _count) % EC_TRACE_EVENTS;
+
+  out.print("# ufire-ec-trace 1 dropped ");
+  out.println(_dropped);
+  for (uint16_t i = 0; i < _count; i++)
+  {
+    const uFire_EC_TraceEvent &e = _events[(first + i) % EC_TRACE_EVENTS];
+    out.print(e.micros);
+    out.print(',');
+    out.print(e.phase);
+    out.print(',');
+    out.print(e.address);
+    out.print(',');
+    out.println(e.begin ? 'B' : 'E');
+  }
+  clear();
+}
+#endif // if defined(UFIRE_EC_TRACE)
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <uFire_EC.h>
+
+#ifndef EC_TRACE_EVENTS
+# define EC_TRACE_EVENTS 64              /*!< events kept in the trace buffer */
+#endif // ifndef EC_TRACE_EVENTS
+
+#define EC_TRACE_WRITE_REGISTER 0        /*!< multi-byte register write */
+#define EC_TRACE_WRITE_BYTE 1            /*!< single byte register write */
+#define EC_TRACE_SEND_COMMAND 2          /*!< _send_command */
+#define EC_TRACE_CONVERSION 3            /*!< waiting for the device to measure */
+#define EC_TRACE_READ_REGISTER 4         /*!< multi-byte register read */
+#define EC_TRACE_READ_BYTE 5             /*!< single byte register read */
+#define EC_TRACE_UPDATE 6                /*!< _updateRegisters */
+#define EC_TRACE_JSON 7                  /*!< uFire_EC_JSON::processJSON */
+#define EC_TRACE_MP 8                    /*!< uFire_EC_MP::processMP */
+
+struct uFire_EC_TraceEvent               /*! One begin or end mark */
+{
+  uint32_t micros;                       /*!< timestamp from micros() */
+  uint8_t  phase;                        /*!< EC_TRACE_* */
+  uint8_t  address;                      /*!< I2C address of the probe */
+  bool     begin;                        /*!< true for begin, false for end */
+};
+
+class uFire_EC_Trace /*! Fixed-size timeline of bus and processing phases */
+{
+public:
+  static void     record(uint8_t phase, uint8_t address, bool begin);
+  static uint16_t count();
+  static uint32_t dropped();
+  static void     clear();
+  static void     dump(Print &out);
+
+private:
+  static uFire_EC_TraceEvent _events[EC_TRACE_EVENTS];
+  static uint16_t _head;
+  static uint16_t _count;
+  static uint32_t _dropped;
+};
+
+// UFIRE_EC_TRACE, given as a compiler flag, turns the marks on; without it
+// they compile to nothing and the buffer takes no RAM
+#if defined(UFIRE_EC_TRACE)
+# define EC_TRACE_BEGIN(phase, address) uFire_EC_Trace::record(phase, address, true)
+# define EC_TRACE_END(phase, address) uFire_EC_Trace::record(phase, address, false)
+#else // if defined(UFIRE_EC_TRACE)
+# define EC_TRACE_BEGIN(phase, address)
+# define EC_TRACE_END(phase, address)
+#endif // if defined(UFIRE_EC_TRACE)